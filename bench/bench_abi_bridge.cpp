@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+#include "bench_abi_bridge.hpp"
+#include "bench_common.hpp"
+
+namespace {
+// a C++11 ABI client of a library that returns std::string: no bridge at all
+void abi_bridge_direct(benchmark::State & state)
+{
+    auto object = a::create_internal_class_instance(1, long_name);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(abi_bridge_round_trip_direct(object));
+}
+BENCHMARK(abi_bridge_direct);
+
+// a C++11 ABI client: the same string_view / string_wrapper round trip as the pre-C++11 one.
+// compare with abi_bridge_direct for the cost of the bridge itself
+void abi_bridge_cxx11_abi(benchmark::State & state)
+{
+    auto object = a::create_internal_class_instance(1, long_name);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(abi_bridge_round_trip_cxx11_abi(object));
+}
+BENCHMARK(abi_bridge_cxx11_abi);
+
+// a pre-C++11 ABI client of the same library, e.g. a PyTorch plugin. compare with abi_bridge_cxx11_abi
+// and abi_bridge_direct
+void abi_bridge_pre_cxx11_abi(benchmark::State & state)
+{
+    auto object = a::create_internal_class_instance(1, long_name);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(abi_bridge_round_trip_pre_cxx11_abi(object));
+}
+BENCHMARK(abi_bridge_pre_cxx11_abi);
+}
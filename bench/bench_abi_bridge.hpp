@@ -0,0 +1,20 @@
+#ifndef API_UPDATES_BENCH_ABI_BRIDGE_HPP
+#define API_UPDATES_BENCH_ABI_BRIDGE_HPP
+#include <api_updates/api.hpp>
+#include <cstddef>
+#include <string>
+
+// the client side of bench_abi_bridge.cpp. bench_abi_bridge_client.cpp is compiled once with each
+// libstdc++ string ABI; the signatures don't involve std::string, so both objects link into one benchmark.
+// each call inits with a std::string name and reads the name of object back into a std::string
+std::size_t abi_bridge_round_trip_cxx11_abi(a::internal_class_sptr const & object);
+std::size_t abi_bridge_round_trip_pre_cxx11_abi(a::internal_class_sptr const & object);
+
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+// the baseline without the bridge: the same round trip through a std::string-returning entry point
+// (bench_abi_bridge_direct.cpp), which a library can only offer to clients with its own string ABI
+std::string abi_bridge_direct_get_name(a::internal_class_sptr const & class_ptr);
+std::size_t abi_bridge_round_trip_direct(a::internal_class_sptr const & object);
+#endif
+
+#endif //API_UPDATES_BENCH_ABI_BRIDGE_HPP
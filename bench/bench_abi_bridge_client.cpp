@@ -0,0 +1,27 @@
+#include "bench_abi_bridge.hpp"
+#include "bench_common.hpp"
+#include <string>
+
+// the same source for both ABIs: a::params, a::init(params const &) and a::get_name are the inline
+// parts of the client's own ABI, everything below them is the library's C++11 ABI
+#if defined(API_UPDATES_PRE_CXX11_ABI)
+std::size_t abi_bridge_round_trip_pre_cxx11_abi(a::internal_class_sptr const & object)
+#else
+std::size_t abi_bridge_round_trip_cxx11_abi(a::internal_class_sptr const & object)
+#endif
+{
+    static a::params const params{long_name, 1};
+    a::init(params);                         // std::string -> std::string_view -> library
+    std::string name = a::get_name(object);  // library -> string_wrapper -> std::string
+    return name.size();
+}
+
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+std::size_t abi_bridge_round_trip_direct(a::internal_class_sptr const & object)
+{
+    static a::params const params{long_name, 1};
+    a::init(params);
+    std::string name = abi_bridge_direct_get_name(object); // library -> std::string
+    return name.size();
+}
+#endif
@@ -0,0 +1,14 @@
+#include "bench_abi_bridge.hpp"
+#include "internal_class.hpp"
+
+// what the library would export if it had only C++11 ABI clients: the name straight into a std::string.
+// kept out of line like a library entry point, also when the bundled build compiles everything with LTO
+#if defined(__clang__)
+__attribute__((noinline))
+#else
+__attribute__((noipa))
+#endif
+std::string abi_bridge_direct_get_name(a::internal_class_sptr const & class_ptr)
+{
+    return std::string(class_ptr->get_name());
+}
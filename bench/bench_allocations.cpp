@@ -0,0 +1,52 @@
+// counts the allocations of the calling thread. replacing the global operator new in the executable
+// also counts the allocations the library makes
+#include "bench_common.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local std::uint64_t allocations = 0;
+}
+
+std::uint64_t allocations_on_this_thread()
+{
+    return allocations;
+}
+
+void * operator new(std::size_t size)
+{
+    ++allocations;
+    if (void * ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned forms
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void * ptr = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
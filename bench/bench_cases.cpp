@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+
+namespace {
+// case 1: current foo(int). compare with foo_v_0
+void foo_v_1(benchmark::State & state)
+{
+    for (auto _ : state)
+        a::foo(0);
+}
+BENCHMARK(foo_v_1);
+
+// foo(int) through the api_table: an indirect call instead of a PLT hop
+void foo_api_table(benchmark::State & state)
+{
+    auto const & table = a::cached_api_table();
+    for (auto _ : state)
+        table.foo(0);
+}
+BENCHMARK(foo_api_table);
+
+// case 3: inline part inlined into the client
+void bar_inline(benchmark::State & state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::bar());
+}
+BENCHMARK(bar_inline);
+
+// the code a client gets when the compiler decides not to inline bar().
+// gcc's noinline still lets it propagate the constant result, noipa doesn't
+#if defined(__clang__)
+__attribute__((noinline))
+#else
+__attribute__((noipa))
+#endif
+int bar_not_inlined()
+{
+    return a::bar();
+}
+
+// case 3: inline part called out of line
+void bar_out_of_line(benchmark::State & state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(bar_not_inlined());
+}
+BENCHMARK(bar_out_of_line);
+}
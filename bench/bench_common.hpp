@@ -0,0 +1,11 @@
+#ifndef API_UPDATES_BENCH_COMMON_HPP
+#define API_UPDATES_BENCH_COMMON_HPP
+#include <cstdint>
+
+// long enough to defeat the small string optimization, like the names on the config-reload path
+inline constexpr char long_name[] = "a-component-name-that-is-much-longer-than-the-small-string-buffer";
+
+// number of operator new calls made by the calling thread so far (bench_allocations.cpp)
+std::uint64_t allocations_on_this_thread();
+
+#endif //API_UPDATES_BENCH_COMMON_HPP
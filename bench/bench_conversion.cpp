@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include "params_conversion.hpp"
+#include <string>
+#include <string_view>
+
+// case 2 - params of four generations, the newest is the view the library entry point takes.
+// gen_2 renames name to full_name
+namespace gen_0 { struct params { std::string name; }; }
+namespace gen_1 { struct params { std::string name; int age = 0; }; }
+namespace gen_2 { struct params { std::string full_name; int age = 0; bool verified = false; }; }
+namespace gen_3 { struct params_view { std::string_view full_name; int age = 0; bool verified = false; int priority = 0; }; }
+
+namespace a::detail {
+template<>
+struct next_generation<gen_0::params> {
+    using type   = gen_1::params;
+    using fields = field_list<field_map<&gen_0::params::name, &gen_1::params::name>>;
+};
+template<>
+struct next_generation<gen_1::params> {
+    using type   = gen_2::params;
+    using fields = field_list<field_map<&gen_1::params::name, &gen_2::params::full_name>,
+                              field_map<&gen_1::params::age, &gen_2::params::age>>;
+};
+template<>
+struct next_generation<gen_2::params> {
+    using type   = gen_3::params_view;
+    using fields = field_list<field_map<&gen_2::params::full_name, &gen_3::params_view::full_name>,
+                              field_map<&gen_2::params::age, &gen_3::params_view::age>,
+                              field_map<&gen_2::params::verified, &gen_3::params_view::verified>>;
+};
+}
+
+namespace {
+// what the shims do when each generation converts to the next one: a temporary struct and a copy of the name per hop
+gen_1::params to_next(gen_0::params const & p) { return {p.name}; }
+gen_2::params to_next(gen_1::params const & p) { return {p.name, p.age}; }
+
+template<class Params>
+void convert_direct(benchmark::State & state)
+{
+    Params params{long_name};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::detail::convert<gen_3::params_view>(params));
+}
+BENCHMARK_TEMPLATE(convert_direct, gen_2::params);
+BENCHMARK_TEMPLATE(convert_direct, gen_1::params);
+BENCHMARK_TEMPLATE(convert_direct, gen_0::params);
+
+void convert_chained_gen_0(benchmark::State & state)
+{
+    gen_0::params params{long_name};
+    for (auto _ : state) {
+        gen_2::params hop = to_next(to_next(params));
+        benchmark::DoNotOptimize(a::detail::convert<gen_3::params_view>(hop));
+    }
+}
+BENCHMARK(convert_chained_gen_0);
+}
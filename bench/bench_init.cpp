@@ -0,0 +1,159 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+#include "bench_common.hpp"
+#include <future>
+#include <vector>
+
+namespace {
+// case 2: native v_1 call. compare with init_v_0_shim
+void init_v_1(benchmark::State & state)
+{
+    a::params params;
+    params.name = long_name;
+    for (auto _ : state)
+        a::init(params);
+}
+BENCHMARK(init_v_1);
+
+// caller that holds the name in its own buffer
+void init_v_1_view(benchmark::State & state)
+{
+    a::params_view params{long_name};
+    for (auto _ : state)
+        a::init(params);
+}
+BENCHMARK(init_v_1_view);
+
+// params with an interned name: 8 bytes instead of sizeof(params) plus a heap block for long names
+void init_compact(benchmark::State & state)
+{
+    a::compact_params params{a::intern_name(long_name)};
+    for (auto _ : state)
+        a::init(params);
+    state.counters["bytes_per_params"] = sizeof(params);
+    state.counters["bytes_per_params_std"] = sizeof(a::params) + sizeof(long_name);
+}
+BENCHMARK(init_compact);
+
+// init from a flat buffer: the name is a view into the buffer. compare with init_v_1_view
+void init_from_buffer(benchmark::State & state)
+{
+    std::vector<std::byte> buffer(a::write_params(a::params_view{long_name}, nullptr, 0));
+    a::write_params(a::params_view{long_name}, buffer.data(), buffer.size());
+    for (auto _ : state)
+        a::init_from_buffer(buffer.data(), buffer.size());
+}
+BENCHMARK(init_from_buffer);
+
+// startup from 100k config records: parsed into std::string-based params, then init_batch,
+// vs init_from_mapping reading the records in place
+constexpr std::size_t config_records = 100000;
+
+std::vector<std::byte> const & config_mapping()
+{
+    static std::vector<std::byte> const mapping = [] {
+        std::vector<a::params> records(config_records, a::params{long_name, 1});
+        std::vector<std::byte> result(a::write_params_mapping(records.data(), records.size(), nullptr, 0));
+        a::write_params_mapping(records.data(), records.size(), result.data(), result.size());
+        return result;
+    }();
+    return mapping;
+}
+
+void init_config_parsed(benchmark::State & state)
+{
+    auto const & mapping = config_mapping();
+    std::size_t record_size = a::write_params(a::params_view{long_name}, nullptr, 0);
+    std::byte const * first_record = mapping.data() + mapping.size() - config_records * record_size;
+    for (auto _ : state) {
+        std::vector<a::params> records(config_records);
+        for (std::size_t i = 0; i < config_records; ++i) {
+            a::params_view record;
+            a::read_params(first_record + i * record_size, record_size, record);
+            records[i] = a::params{std::string(record.name), record.age};
+        }
+        a::init_batch(records.data(), records.size(), state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * config_records);
+}
+BENCHMARK(init_config_parsed)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+void init_config_mapping(benchmark::State & state)
+{
+    auto const & mapping = config_mapping();
+    for (auto _ : state)
+        a::init_from_mapping(mapping.data(), mapping.size(), state.range(0));
+    state.SetItemsProcessed(state.iterations() * config_records);
+}
+BENCHMARK(init_config_mapping)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// intern_name of a name that is in the pool already
+void intern_name(benchmark::State & state)
+{
+    a::intern_name(long_name);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::intern_name(long_name));
+}
+BENCHMARK(intern_name);
+
+// generation 0 behavior selected at compile time. compare with init_v_0_shim
+void init_version_0(benchmark::State & state)
+{
+    a::params_t<0> params{long_name};
+    for (auto _ : state)
+        a::init<0>(params);
+}
+BENCHMARK(init_version_0);
+
+// init on a library thread, waiting for each call
+void init_async_future(benchmark::State & state)
+{
+    a::params_view params{long_name};
+    for (auto _ : state)
+        a::init_async(params).get();
+}
+BENCHMARK(init_async_future);
+
+// startup of state.range(0) components: one after another vs all queued at once
+void init_components_serial(benchmark::State & state)
+{
+    a::params_view params{long_name};
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); ++i)
+            a::init(params);
+    }
+}
+BENCHMARK(init_components_serial)->Arg(32);
+
+void init_components_async(benchmark::State & state)
+{
+    a::params_view params{long_name};
+    std::vector<std::future<void>> pending(state.range(0));
+    for (auto _ : state) {
+        for (auto & component : pending)
+            component = a::init_async(params);
+        for (auto & component : pending)
+            component.get();
+    }
+}
+BENCHMARK(init_components_async)->Arg(32);
+
+// 4096 inits split over state.range(0) threads at most (the caller and the library threads), in output mode
+// state.range(1). the suite runs in discard mode, where init is next to nothing and only the cost of handing
+// out the elements is left. in sync_stdout mode each init formats its record through std::cout (a null buffer
+// here) like a default-mode init does, so that is where the scaling of real per-element work shows
+void init_batch(benchmark::State & state)
+{
+    std::vector<a::params> batch(4096, a::params{long_name, 1});
+    a::set_output_mode(static_cast<a::output_mode>(state.range(1)));
+    for (auto _ : state)
+        a::init_batch(batch.data(), batch.size(), state.range(0));
+    a::set_output_mode(a::output_mode::discard);
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(init_batch)
+    ->ArgNames({"threads", "mode"})
+    ->ArgsProduct({benchmark::CreateRange(1, 64, 2),
+                   {static_cast<int>(a::output_mode::sync_stdout), static_cast<int>(a::output_mode::discard)}})
+    ->UseRealTime();
+}
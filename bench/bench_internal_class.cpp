@@ -0,0 +1,208 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+#include "bench_common.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+// short-lived handle: created and dropped right away
+void create_internal_class_instance(benchmark::State & state)
+{
+    int value = 0;
+    for (auto _ : state) {
+        auto instance = a::create_internal_class_instance(++value);
+        benchmark::DoNotOptimize(instance);
+    }
+}
+BENCHMARK(create_internal_class_instance);
+
+// a named object per request: on the global heap (and the per-thread pool), then on a per-request arena
+void create_named_instance(benchmark::State & state)
+{
+    auto allocations = allocations_on_this_thread();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::create_internal_class_instance(1, long_name));
+    state.counters["allocations_per_call"] = benchmark::Counter(
+        static_cast<double>(allocations_on_this_thread() - allocations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(create_named_instance);
+
+void create_named_instance_arena(benchmark::State & state)
+{
+    alignas(std::max_align_t) std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    std::pmr::memory_resource * previous = a::set_thread_memory_resource(&arena);
+    auto allocations = allocations_on_this_thread();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a::create_internal_class_instance(1, long_name));
+        arena.release(); // the request is done
+    }
+    state.counters["allocations_per_call"] = benchmark::Counter(
+        static_cast<double>(allocations_on_this_thread() - allocations), benchmark::Counter::kAvgIterations);
+    a::set_thread_memory_resource(previous);
+}
+BENCHMARK(create_named_instance_arena);
+
+// case 5: the wrapper class - construct + one get_value
+void exposed_internal_class_construct_get_value(benchmark::State & state)
+{
+    for (auto _ : state) {
+        a::exposed_internal_class instance(25);
+        benchmark::DoNotOptimize(instance.get_value());
+    }
+}
+BENCHMARK(exposed_internal_class_construct_get_value);
+
+// the handle wrapper - construct + one get_value + destroy, which takes a grace period once per batch of handles
+void light_exposed_internal_class_construct_get_value(benchmark::State & state)
+{
+    for (auto _ : state) {
+        a::light_exposed_internal_class instance(25);
+        benchmark::DoNotOptimize(instance.get_value());
+    }
+}
+BENCHMARK(light_exposed_internal_class_construct_get_value);
+
+// case 5: get_value through the wrapper
+void exposed_internal_class_get_value(benchmark::State & state)
+{
+    a::exposed_internal_class instance(25);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(instance.get_value());
+}
+BENCHMARK(exposed_internal_class_get_value);
+
+// case 5: get_value through the wrapper when every read follows a set_value
+void exposed_internal_class_set_get_value(benchmark::State & state)
+{
+    a::exposed_internal_class instance(25);
+    int value = 0;
+    for (auto _ : state) {
+        instance.set_value(++value);
+        benchmark::DoNotOptimize(instance.get_value());
+    }
+}
+BENCHMARK(exposed_internal_class_set_get_value);
+
+// case 5: get_value through the api_table
+void get_value_api_table(benchmark::State & state)
+{
+    auto const & table = a::cached_api_table();
+    auto instance = a::create_internal_class_instance(25);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(table.get_value(instance));
+}
+BENCHMARK(get_value_api_table);
+
+void create_internal_class_instances(benchmark::State & state)
+{
+    std::vector<int> values(state.range(0), 42);
+    std::vector<a::internal_class_sptr> instances(values.size());
+    for (auto _ : state) {
+        a::create_internal_class_instances(values.data(), values.size(), instances.data());
+        benchmark::DoNotOptimize(instances.data());
+        for (auto & instance : instances)
+            instance.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(create_internal_class_instances)->Arg(1024);
+
+// get_name() through string_wrapper: no allocation for names that fit both string_wrapper and std::string inline
+void get_name(benchmark::State & state)
+{
+    std::string name(state.range(0), 'n');
+    auto instance = a::create_internal_class_instance(1, name);
+    auto allocations = allocations_on_this_thread();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::get_name(instance));
+    state.counters["allocations_per_call"] = benchmark::Counter(
+        static_cast<double>(allocations_on_this_thread() - allocations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(get_name)->ArgName("name_length")->Arg(4)->Arg(15)->Arg(23)->Arg(64);
+
+// the name copied into a buffer the caller owns
+void get_name_into_buffer(benchmark::State & state)
+{
+    std::string name(state.range(0), 'n');
+    auto instance = a::create_internal_class_instance(1, name);
+    char buffer[256];
+    auto allocations = allocations_on_this_thread();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::get_name(instance, buffer, sizeof(buffer)));
+    state.counters["allocations_per_call"] = benchmark::Counter(
+        static_cast<double>(allocations_on_this_thread() - allocations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(get_name_into_buffer)->ArgName("name_length")->Arg(4)->Arg(64);
+
+// the name in the reused per-thread buffer
+void get_name_view(benchmark::State & state)
+{
+    std::string name(state.range(0), 'n');
+    auto instance = a::create_internal_class_instance(1, name);
+    a::get_name_view(instance); // grow the buffer
+    auto allocations = allocations_on_this_thread();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a::get_name_view(instance));
+    state.counters["allocations_per_call"] = benchmark::Counter(
+        static_cast<double>(allocations_on_this_thread() - allocations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(get_name_view)->ArgName("name_length")->Arg(4)->Arg(64)->Arg(256);
+
+// aggregate over many handles: one library call per element
+void get_value_loop(benchmark::State & state)
+{
+    std::vector<a::internal_class_sptr> instances(state.range(0));
+    for (auto & instance : instances)
+        instance = a::create_internal_class_instance(1);
+    for (auto _ : state) {
+        long sum = 0;
+        for (auto const & instance : instances)
+            sum += a::get_value(instance);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(get_value_loop)->Arg(10000);
+
+// the same aggregation with one library call per batch
+void get_values_batch(benchmark::State & state)
+{
+    std::vector<a::internal_class_sptr> instances(state.range(0));
+    for (auto & instance : instances)
+        instance = a::create_internal_class_instance(1);
+    std::vector<int> values(instances.size());
+    for (auto _ : state) {
+        a::get_values(instances.data(), instances.size(), values.data());
+        long sum = 0;
+        for (int value : values)
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(get_values_batch)->Arg(10000);
+
+// many threads reading one shared object through copies of its shared_ptr
+void exposed_internal_class_copy_read(benchmark::State & state)
+{
+    static a::exposed_internal_class shared_instance(1);
+    for (auto _ : state) {
+        a::exposed_internal_class copy = shared_instance;
+        benchmark::DoNotOptimize(copy.get_value());
+    }
+}
+BENCHMARK(exposed_internal_class_copy_read)->ThreadRange(1, 8);
+
+// the same through copies of the handle
+void light_exposed_internal_class_copy_read(benchmark::State & state)
+{
+    static a::light_exposed_internal_class shared_instance(1);
+    for (auto _ : state) {
+        a::internal_class_handle copy = shared_instance.handle();
+        benchmark::DoNotOptimize(a::get_value(copy));
+    }
+}
+BENCHMARK(light_exposed_internal_class_copy_read)->ThreadRange(1, 8);
+}
@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+#include <iostream>
+#include <streambuf>
+
+namespace {
+// swallows what reaches std::cout in the benchmarks that measure sync_stdout output
+class null_buffer : public std::streambuf {
+protected:
+    int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+    std::streamsize xsputn(char const *, std::streamsize count) override { return count; }
+};
+}
+
+int main(int argc, char ** argv)
+{
+    null_buffer null_buf;
+    std::ostream report(std::cout.rdbuf(&null_buf));
+    // the numbers should show the cost of the calls, not of the output. bench_output.cpp measures that
+    a::set_output_mode(a::output_mode::discard);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::ConsoleReporter reporter(benchmark::ConsoleReporter::OO_Tabular);
+    reporter.SetOutputStream(&report);
+    reporter.SetErrorStream(&std::cerr);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    std::cout.rdbuf(report.rdbuf());
+    return 0;
+}
@@ -0,0 +1,48 @@
+// an old client: compiled against the original header, which only had these declarations.
+// every call here lands on a compatibility entry point of the library
+#include <benchmark/benchmark.h>
+#include "bench_common.hpp"
+#include <memory>
+#include <string>
+
+namespace a{
+class internal_class;
+inline namespace v_0{
+    struct params{
+        std::string name;
+    };
+    void init(params const & init_params);
+    void foo();
+    std::shared_ptr<internal_class> create_internal_class_instance(int value);
+}}
+
+namespace {
+// case 1: the old foo() forwarding to foo(int)
+void foo_v_0(benchmark::State & state)
+{
+    for (auto _ : state)
+        a::foo();
+}
+BENCHMARK(foo_v_0);
+
+// case 2: the v_0 -> v_1 init shim
+void init_v_0_shim(benchmark::State & state)
+{
+    a::params params;
+    params.name = long_name;
+    for (auto _ : state)
+        a::init(params);
+}
+BENCHMARK(init_v_0_shim);
+
+// case 1: the old create_internal_class_instance(int). compare with create_internal_class_instance
+void create_internal_class_instance_v_0(benchmark::State & state)
+{
+    int value = 0;
+    for (auto _ : state) {
+        auto instance = a::create_internal_class_instance(++value);
+        benchmark::DoNotOptimize(instance);
+    }
+}
+BENCHMARK(create_internal_class_instance_v_0);
+}
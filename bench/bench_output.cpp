@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+
+namespace {
+void ignore_record(void *, char const *, std::size_t) {}
+
+// the cost a caller of foo() pays for its output in each mode (std::cout goes to a null buffer)
+void foo_output(benchmark::State & state)
+{
+    std::uint64_t dropped = 0;
+    if (state.thread_index() == 0) {
+        a::set_output_sink(&ignore_record, nullptr);
+        dropped = a::dropped_output_records();
+        a::set_output_mode(static_cast<a::output_mode>(state.range(0)));
+    }
+    for (auto _ : state)
+        a::foo(42);
+    if (state.thread_index() == 0) {
+        a::flush_output();
+        a::set_output_mode(a::output_mode::discard);
+        a::set_output_sink(nullptr, nullptr);
+        state.counters["dropped"] = static_cast<double>(a::dropped_output_records() - dropped);
+    }
+}
+BENCHMARK(foo_output)
+    ->ArgName("mode")
+    ->Arg(static_cast<int>(a::output_mode::sync_stdout))
+    ->Arg(static_cast<int>(a::output_mode::async))
+    ->Arg(static_cast<int>(a::output_mode::discard))
+    ->ThreadRange(1, 4);
+}
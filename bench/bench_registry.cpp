@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+constexpr std::uint64_t registered_keys = 4096;
+
+// what every service used to build around the shared_ptrs: one mutex for all lookups
+struct locked_map {
+    std::mutex                                              mutex;
+    std::unordered_map<std::uint64_t, a::internal_class_sptr> map;
+
+    locked_map()
+    {
+        // services are multi-threaded. without a second thread the 1-thread run would get the
+        // non-atomic reference counts libstdc++ uses in single-threaded processes
+        std::thread([] {}).join();
+        for (std::uint64_t key = 0; key < registered_keys; ++key)
+            map.emplace(key, a::create_internal_class_instance(static_cast<int>(key)));
+    }
+
+    a::internal_class_sptr find(std::uint64_t key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : it->second;
+    }
+};
+
+void locked_map_find(benchmark::State & state)
+{
+    static locked_map map;
+    std::uint64_t key = state.thread_index();
+    for (auto _ : state) {
+        key = (key + 7) % registered_keys;
+        benchmark::DoNotOptimize(map.find(key));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(locked_map_find)->ThreadRange(1, 8);
+
+void register_keys()
+{
+    static bool registered = [] {
+        for (std::uint64_t key = 0; key < registered_keys; ++key)
+            a::register_instance(key, a::create_internal_class_instance(static_cast<int>(key)));
+        return true;
+    }();
+    benchmark::DoNotOptimize(registered);
+}
+
+// case 5 - the library registry: no lock on the read path
+void find_instance(benchmark::State & state)
+{
+    register_keys();
+    std::uint64_t key = state.thread_index();
+    for (auto _ : state) {
+        key = (key + 7) % registered_keys;
+        benchmark::DoNotOptimize(a::find_instance(key));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(find_instance)->ThreadRange(1, 8);
+
+// lookups while thread 0 keeps replacing entries
+void find_instance_with_writer(benchmark::State & state)
+{
+    register_keys();
+    std::uint64_t key = state.thread_index();
+    for (auto _ : state) {
+        key = (key + 7) % registered_keys;
+        if (state.thread_index() == 0)
+            a::register_instance(key, a::create_internal_class_instance(static_cast<int>(key)));
+        else
+            benchmark::DoNotOptimize(a::find_instance(key));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(find_instance_with_writer)->ThreadRange(2, 8);
+}
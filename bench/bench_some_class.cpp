@@ -0,0 +1,26 @@
+#include <benchmark/benchmark.h>
+#include <api_updates/api.hpp>
+#include <vector>
+
+namespace {
+// case 4: two virtual calls and one library call per element
+void use_some_class_loop(benchmark::State & state)
+{
+    std::vector<a::some_class> elements(state.range(0), a::some_class(5, 6));
+    for (auto _ : state)
+        for (auto & element : elements)
+            a::use_some_class(element);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(use_some_class_loop)->Arg(4096);
+
+// no virtual calls and one library call per 256 elements
+void use_some_class_batch(benchmark::State & state)
+{
+    std::vector<a::some_class> elements(state.range(0), a::some_class(5, 6));
+    for (auto _ : state)
+        a::use_some_class(elements.begin(), elements.end());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(use_some_class_batch)->Arg(4096);
+}
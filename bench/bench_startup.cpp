@@ -0,0 +1,37 @@
+// load cost of a library that keeps N ABI generations: inline namespaces vs ELF symbol versions.
+// each iteration loads a client library the way a service starts: the client and the library it
+// depends on are mapped and every reference is bound (RTLD_NOW)
+#include <benchmark/benchmark.h>
+#include <dlfcn.h>
+#include <string>
+#include "bench_startup_libraries.hpp"
+
+namespace {
+void load_client(benchmark::State & state, char const * path)
+{
+    for (auto _ : state) {
+        void * handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            state.SkipWithError(dlerror());
+            break;
+        }
+        auto client_call = reinterpret_cast<int (*)(int)>(dlsym(handle, "client_call"));
+        benchmark::DoNotOptimize(client_call(1));
+        dlclose(handle);
+    }
+}
+}
+
+int main(int argc, char ** argv)
+{
+    for (auto const & library : startup_libraries) {
+        std::string name = std::string("load_client/") + library.mode + "/generations:" + std::to_string(library.generations);
+        benchmark::RegisterBenchmark(name.c_str(), &load_client, library.path);
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
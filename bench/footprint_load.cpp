@@ -0,0 +1,67 @@
+// dlopen + first call of the library in a fresh process, the way a service pays for it at startup.
+// prints the fastest of the runs in microseconds (the least disturbed by the rest of the machine). usage: footprint_load <library> [runs]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+// a::v_0::foo(int): exported by every generation of the library
+constexpr char first_call[] = "_ZN1a3v_03fooEi";
+
+// runs in the child. returns the time in nanoseconds, -1 on failure
+long long load_and_call(char const * path)
+{
+    auto start = std::chrono::steady_clock::now();
+    void * handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle)
+        return -1;
+    auto foo = reinterpret_cast<void (*)(int)>(dlsym(handle, first_call));
+    if (!foo)
+        return -1;
+    foo(0);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <library> [runs]\n", argv[0]);
+        return 2;
+    }
+    int runs = argc > 2 ? std::atoi(argv[2]) : 51;
+    std::vector<long long> samples;
+    for (int i = 0; i < runs; ++i) {
+        int fds[2];
+        if (pipe(fds) != 0)
+            return 1;
+        pid_t child = fork();
+        if (child == 0) {
+            // foo prints; keep it out of the report
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDOUT_FILENO);
+            long long ns = load_and_call(argv[1]);
+            if (ns < 0)
+                std::fprintf(stderr, "%s\n", dlerror());
+            static_cast<void>(write(fds[1], &ns, sizeof(ns)));
+            _exit(0);
+        }
+        close(fds[1]);
+        long long ns = -1;
+        if (read(fds[0], &ns, sizeof(ns)) != sizeof(ns))
+            ns = -1;
+        close(fds[0]);
+        waitpid(child, nullptr, 0);
+        if (ns < 0)
+            return 1;
+        samples.push_back(ns);
+    }
+    std::printf("%lld\n", *std::min_element(samples.begin(), samples.end()) / 1000);
+    return 0;
+}
@@ -0,0 +1,107 @@
+# ABI footprint of the shared library, compared with a stored baseline. run in script mode:
+#   cmake -DLIBRARY=<.so> -DNM=<nm> -DREADELF=<readelf> -DLOAD=<footprint_load> -DBASELINE=<file>
+#         -DTHRESHOLD=<percent> -DLATENCY_THRESHOLD=<percent> [-DUPDATE=ON] -P abi_footprint.cmake
+# metrics: file size, exported symbols (in total and per version namespace), dynamic relocations,
+# PLT relocations and the fastest dlopen + first call time of several runs. a metric fails when it is more than its
+# threshold above the baseline. UPDATE=ON writes the current values as the new baseline instead
+
+set(metrics "")
+macro(_metric name value)
+    set(metric_${name} ${value})
+    list(APPEND metrics ${name})
+endmacro()
+
+file(SIZE "${LIBRARY}" size)
+_metric(file_bytes ${size})
+
+execute_process(COMMAND "${NM}" -D --defined-only -C "${LIBRARY}" OUTPUT_VARIABLE symbols RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}")
+endif()
+# demangled names may contain [abi:cxx11], which would stop list splitting at ';'
+string(REPLACE "[" "<" symbols "${symbols}")
+string(REPLACE "]" ">" symbols "${symbols}")
+string(REPLACE "\n" ";" symbols "${symbols}")
+set(total 0)
+set(namespaces "")
+foreach(symbol IN LISTS symbols)
+    if(symbol STREQUAL "")
+        continue()
+    endif()
+    math(EXPR total "${total} + 1")
+    # the innermost versioned namespace of a::: v_N, inline_v_N, string_wrapper_v_N, ...
+    if(symbol MATCHES "a::([a-z_]*v_[0-9]+)::")
+        set(ns ${CMAKE_MATCH_1})
+    else()
+        set(ns other)
+    endif()
+    if(NOT DEFINED count_${ns})
+        set(count_${ns} 0)
+        list(APPEND namespaces ${ns})
+    endif()
+    math(EXPR count_${ns} "${count_${ns}} + 1")
+endforeach()
+_metric(exported_symbols ${total})
+list(SORT namespaces)
+foreach(ns IN LISTS namespaces)
+    _metric(symbols_${ns} ${count_${ns}})
+endforeach()
+
+execute_process(COMMAND "${READELF}" -W -r "${LIBRARY}" OUTPUT_VARIABLE relocations RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${READELF} failed on ${LIBRARY}")
+endif()
+foreach(section dyn plt)
+    set(count 0)
+    if(relocations MATCHES "'\\.rela?\\.${section}' at offset 0x[0-9a-f]+ contains ([0-9]+) entr")
+        set(count ${CMAKE_MATCH_1})
+    endif()
+    _metric(relocations_${section} ${count})
+endforeach()
+
+execute_process(COMMAND "${LOAD}" "${LIBRARY}" OUTPUT_VARIABLE load_us RESULT_VARIABLE result OUTPUT_STRIP_TRAILING_WHITESPACE)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${LOAD} could not load ${LIBRARY}")
+endif()
+_metric(dlopen_first_call_us ${load_us})
+
+if(UPDATE)
+    set(content "# written by the abi_footprint_baseline target. values of the last accepted build\n")
+    foreach(name IN LISTS metrics)
+        string(APPEND content "set(baseline_${name} ${metric_${name}})\n")
+    endforeach()
+    file(WRITE "${BASELINE}" "${content}")
+    message(STATUS "abi footprint: baseline written to ${BASELINE}")
+    return()
+endif()
+
+if(EXISTS "${BASELINE}")
+    include("${BASELINE}")
+else()
+    message(WARNING "abi footprint: no baseline at ${BASELINE}, build abi_footprint_baseline to create it")
+endif()
+
+set(failed "")
+message(STATUS "abi footprint of ${LIBRARY}")
+foreach(name IN LISTS metrics)
+    set(line "  ${name}: ${metric_${name}}")
+    if(DEFINED baseline_${name})
+        if(name STREQUAL "dlopen_first_call_us")
+            set(threshold ${LATENCY_THRESHOLD})
+        else()
+            set(threshold ${THRESHOLD})
+        endif()
+        math(EXPR limit "${baseline_${name}} + ${baseline_${name}} * ${threshold} / 100")
+        string(APPEND line " (baseline ${baseline_${name}}, limit ${limit})")
+        if(metric_${name} GREATER limit)
+            string(APPEND line " FAILED")
+            list(APPEND failed ${name})
+        endif()
+    elseif(EXISTS "${BASELINE}")
+        string(APPEND line " (not in the baseline)")
+    endif()
+    message(STATUS "${line}")
+endforeach()
+if(failed)
+    message(FATAL_ERROR "abi footprint grew beyond the threshold: ${failed}")
+endif()
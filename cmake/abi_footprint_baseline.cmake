@@ -0,0 +1,12 @@
+# written by the abi_footprint_baseline target. values of the last accepted build
+set(baseline_file_bytes 121352)
+set(baseline_exported_symbols 117)
+set(baseline_symbols_inline_v_4 2)
+set(baseline_symbols_other 68)
+set(baseline_symbols_v_0 8)
+set(baseline_symbols_v_1 2)
+set(baseline_symbols_v_2 11)
+set(baseline_symbols_v_3 26)
+set(baseline_relocations_dyn 203)
+set(baseline_relocations_plt 105)
+set(baseline_dlopen_first_call_us 112)
@@ -0,0 +1,34 @@
+# reads the compatibility entry points of src/compat_entry_points.def, the one list of them:
+#   read_compat_entry_points(<def file> <jumps>)
+# sets <jumps> to the mangled names of the entries with tail jump. cmake runs again when the manifest changes
+
+# one entry: API_UPDATES_<kind>(...) with up to one level of nested parentheses
+set(_compat_entry_regex "API_UPDATES_(FORWARD|CONVERT)[ ]*\\(([^()]|\\([^()]*\\))*\\)")
+
+function(read_compat_entry_points def_file jumps_out)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${def_file})
+    file(READ ${def_file} manifest)
+    string(REGEX REPLACE "//[^\n]*" "" manifest "${manifest}")
+    string(REPLACE "\n" " " manifest "${manifest}")
+    string(REGEX MATCHALL "${_compat_entry_regex}" entries "${manifest}")
+    if(NOT entries)
+        message(FATAL_ERROR "${def_file}: no compatibility entry points")
+    endif()
+    set(jumps "")
+    foreach(entry IN LISTS entries)
+        # the last arguments: tail (FORWARD only) and symbol
+        if(NOT entry MATCHES ",[ ]*([A-Za-z0-9_]+)[ ]*\\)$")
+            message(FATAL_ERROR "${def_file}: no symbol in ${entry}")
+        endif()
+        set(symbol ${CMAKE_MATCH_1})
+        if(entry MATCHES "^API_UPDATES_FORWARD")
+            if(NOT entry MATCHES ",[ ]*(jump|call)[ ]*,[ ]*[A-Za-z0-9_]+[ ]*\\)$")
+                message(FATAL_ERROR "${def_file}: tail is neither jump nor call in ${entry}")
+            endif()
+            if(CMAKE_MATCH_1 STREQUAL "jump")
+                list(APPEND jumps ${symbol})
+            endif()
+        endif()
+    endforeach()
+    set(${jumps_out} ${jumps} PARENT_SCOPE)
+endfunction()
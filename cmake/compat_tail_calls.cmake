@@ -0,0 +1,50 @@
+# checks that compatibility entry points end in a jump to the current definition. run in script mode:
+#   cmake -DLIBRARY=<.so> -DOBJDUMP=<objdump> -DJUMPS=<mangled names> -P compat_tail_calls.cmake
+# a function fails when its body has a call or its last instruction (nops aside) is not a jmp
+
+execute_process(COMMAND "${OBJDUMP}" -d --no-show-raw-insn "${LIBRARY}" OUTPUT_VARIABLE disassembly RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${OBJDUMP} failed on ${LIBRARY}")
+endif()
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(failed "")
+foreach(name IN LISTS JUMPS)
+    set(inside OFF)
+    set(found OFF)
+    set(last "")
+    set(calls OFF)
+    foreach(line IN LISTS lines)
+        # a symbol with an ELF version (API_UPDATES_SYMBOL_VERSIONS) shows up as name@API_N
+        if(line MATCHES "^[0-9a-f]+ <([^>@]+)(@[^>]*)?>:$")
+            if(inside)
+                break()
+            endif()
+            if(CMAKE_MATCH_1 STREQUAL name)
+                set(inside ON)
+                set(found ON)
+            endif()
+        elseif(inside AND line MATCHES "^ +[0-9a-f]+:[ \t]+([a-z0-9]+)")
+            set(instruction ${CMAKE_MATCH_1})
+            if(instruction MATCHES "^call")
+                set(calls ON)
+            endif()
+            if(NOT instruction MATCHES "^(nop|xchg|data16|cs)")
+                set(last ${instruction})
+            endif()
+        endif()
+    endforeach()
+    if(NOT found)
+        message(STATUS "  ${name}: not found")
+        list(APPEND failed ${name})
+    elseif(calls OR NOT last MATCHES "^jmp")
+        message(STATUS "  ${name}: not a tail call (ends in ${last})")
+        list(APPEND failed ${name})
+    else()
+        message(STATUS "  ${name}: jmp")
+    endif()
+endforeach()
+if(failed)
+    message(FATAL_ERROR "compatibility entry points that should be a jump are not: ${failed}")
+endif()
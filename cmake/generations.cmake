@@ -0,0 +1,100 @@
+# Synthetic libraries for bench_startup. Each one keeps `generations` ABI generations of `functions`
+# entry points a::f<k>(int), expressed in one of two ways:
+#   namespaces - one namespace per generation, the newest one inline (the pattern this repository uses)
+#   symver     - one C++ name per entry point with one ELF symbol version per generation
+#                (.symver aliases + a linker version script)
+# Next to each library there is a client library that - like a freshly built service - references
+# the newest generation of every entry point and exports `int client_call(int)`.
+
+# mangled name of a::<ns>::<name>(int), or a::<name>(int) for an empty ns
+function(_generations_mangle out ns name)
+    string(LENGTH "${name}" name_length)
+    if(ns STREQUAL "")
+        set(${out} "_ZN1a${name_length}${name}Ei" PARENT_SCOPE)
+    else()
+        string(LENGTH "${ns}" ns_length)
+        set(${out} "_ZN1a${ns_length}${ns}${name_length}${name}Ei" PARENT_SCOPE)
+    endif()
+endfunction()
+
+# defines targets generations_<mode>_<generations> and generations_client_<mode>_<generations>
+function(add_generations_library mode generations functions)
+    set(name generations_${mode}_${generations})
+    set(dir ${CMAKE_CURRENT_BINARY_DIR}/generations/${name})
+    math(EXPR last_generation "${generations} - 1")
+    math(EXPR last_function "${functions} - 1")
+
+    set(library_source "namespace a {\n")
+    set(client_source "namespace a {\n")
+    if(mode STREQUAL "namespaces")
+        foreach(g RANGE ${last_generation})
+            if(g EQUAL last_generation)
+                string(APPEND library_source "inline ")
+                string(APPEND client_source "inline namespace v_${g} {\n")
+            endif()
+            string(APPEND library_source "namespace v_${g} {\n")
+            foreach(k RANGE ${last_function})
+                string(APPEND library_source "int f${k}(int x) { return x + ${g}; }\n")
+                if(g EQUAL last_generation)
+                    string(APPEND client_source "int f${k}(int x);\n")
+                endif()
+            endforeach()
+            string(APPEND library_source "}\n")
+        endforeach()
+        string(APPEND library_source "}\n")
+        string(APPEND client_source "}\n}\n")
+    elseif(mode STREQUAL "symver")
+        set(symver_source "")
+        set(version_script "")
+        set(public_names "")
+        foreach(k RANGE ${last_function})
+            _generations_mangle(public "" f${k})
+            string(APPEND public_names "${public}; ")
+        endforeach()
+        string(APPEND library_source "namespace impl {\n")
+        foreach(g RANGE ${last_generation})
+            foreach(k RANGE ${last_function})
+                string(APPEND library_source "int f${k}_v_${g}(int x) { return x + ${g}; }\n")
+                _generations_mangle(implementation impl f${k}_v_${g})
+                _generations_mangle(public "" f${k})
+                if(g EQUAL last_generation)
+                    set(binding "@@")
+                    string(APPEND client_source "int f${k}(int x);\n")
+                else()
+                    set(binding "@")
+                endif()
+                string(APPEND symver_source "__asm__(\".symver ${implementation}, ${public}${binding}API_${g}\");\n")
+            endforeach()
+            # every generation is a version node. the public names have to be listed in each node:
+            # `local: *` would otherwise also hide the aliases .symver assigns to that node
+            if(g EQUAL 0)
+                string(APPEND version_script "API_0 { global: ${public_names} local: *; };\n")
+            else()
+                math(EXPR previous "${g} - 1")
+                string(APPEND version_script "API_${g} { global: ${public_names} } API_${previous};\n")
+            endif()
+        endforeach()
+        string(APPEND library_source "}\n}\n${symver_source}")
+        string(APPEND client_source "}\n")
+        file(WRITE ${dir}/library.map "${version_script}")
+    else()
+        message(FATAL_ERROR "unknown generations mode: ${mode}")
+    endif()
+
+    string(APPEND client_source "extern \"C\" int client_call(int x)\n{\n    return 0")
+    foreach(k RANGE ${last_function})
+        string(APPEND client_source " + a::f${k}(x)")
+    endforeach()
+    string(APPEND client_source ";\n}\n")
+
+    file(WRITE ${dir}/library.cpp "${library_source}")
+    file(WRITE ${dir}/client.cpp "${client_source}")
+
+    add_library(${name} SHARED ${dir}/library.cpp)
+    if(mode STREQUAL "symver")
+        target_link_options(${name} PRIVATE -Wl,--version-script=${dir}/library.map)
+        set_property(TARGET ${name} APPEND PROPERTY LINK_DEPENDS ${dir}/library.map)
+    endif()
+    add_library(generations_client_${mode}_${generations} SHARED ${dir}/client.cpp)
+    target_link_libraries(generations_client_${mode}_${generations} PRIVATE ${name})
+endfunction()
@@ -1,7 +1,32 @@
 #ifndef API_UPDATES_API_HPP
 #define API_UPDATES_API_HPP
+#include <api_updates/export.hpp>
+#include <api_updates/string_wrapper.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// pre-C++11 ABI clients (_GLIBCXX_USE_CXX11_ABI=0, see abi0.md) have another std::string. the library is built
+// with the C++11 ABI, so they only pass names as std::string_view, get them back as string_wrapper, and their
+// inline code that uses std::string lives in namespaces of its own - an inline function is never shared by
+// modules of both ABIs. case 3 changes rename both inline namespaces
+#if defined(_GLIBCXX_USE_CXX11_ABI) && _GLIBCXX_USE_CXX11_ABI == 0
+#  define API_UPDATES_PRE_CXX11_ABI 1
+#  define API_UPDATES_INLINE_NAMESPACE inline_v_4_pre_cxx11_abi
+#else
+#  define API_UPDATES_INLINE_NAMESPACE inline_v_4
+#endif
 
 namespace a{
 
@@ -9,37 +34,372 @@ namespace a{
 class internal_class;
 using internal_class_sptr = std::shared_ptr<internal_class>;
 
+// case 5 - alternative to shared_ptr: a generational index into a library-owned table of internal_class
+// instances. copying it copies two integers and reading through it never updates a reference counter.
+// the layout is part of the ABI and must not change
+struct internal_class_handle {
+    std::uint32_t index      = 0;
+    std::uint32_t generation = 0; // 0 is never a valid generation
+};
+
 // case 2: update version namespace
 inline namespace v_1 {
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
     struct params {
         std::string name;
         int         age = 0; // case 2: add a new field
     };
+#else
+    // the same fields with the client's std::string. the library never sees it: init takes it as a params_view
+    inline namespace pre_cxx11_abi {
+        struct params {
+            std::string name;
+            int         age = 0;
+        };
+    }
+#endif
+
+    // non-owning params. callers that already hold the name in a buffer don't have to build
+    // a std::string to call init
+    struct params_view {
+        std::string_view name;
+        int              age = 0; // same default as params::age
+    };
+    A_API void init(params_view init_params);
 
-    void init(params const &init_params);
+    // this used to be the out-of-line entry point and the library still exports it (hence A_API on an
+    // inline function) for clients built against the old header. its body must never change - add a new version instead
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+    A_API inline void init(params const &init_params) { init(params_view{init_params.name, init_params.age}); }
+#else
+    inline namespace pre_cxx11_abi {
+        inline void init(params const & init_params) { init(params_view{init_params.name, init_params.age}); }
+    }
+#endif
+}
+
+namespace detail {
+    // v_1::params of the C++11 ABI, never defined: api_table has one type for clients of both ABIs, and a
+    // pre-C++11 ABI client can't build the struct anyway. a C++11 ABI client calls those entries through
+    // api_table_init_batch and api_table_write_params_mapping
+    struct library_params;
 }
 
 inline namespace v_0 {
-    void foo(int arg = 0); // case 1: add an argument with a default value (original version has no args)
+    A_API void foo(int arg = 0); // case 1: add an argument with a default value (original version has no args)
 
     // case 4 - non-inline part
-    class some_class_interface{
+    class A_API some_class_interface{
     public:
         virtual int f1() = 0;
         virtual int f2() = 0;
     };
     // non-inline function that uses some_class_interface that exposes f1 and f2 only
-    void use_some_class(some_class_interface & arg);
+    A_API void use_some_class(some_class_interface & arg);
 
     // case 5 - provide a function that instantiates an object of internal_class
-    internal_class_sptr create_internal_class_instance(int value);
+    // case 1: add an argument with a default value (original version has the value only)
+    A_API internal_class_sptr create_internal_class_instance(int value, std::string_view name = {});
+    // case 5 - batch version: out[i] = create_internal_class_instance(values[i]) for i in [0, count)
+    A_API void create_internal_class_instances(int const * values, std::size_t count, internal_class_sptr * out);
     // case 5 - provide functions that redirect calls to internal_class methods
-    int get_value(internal_class_sptr const & class_ptr);
+    A_API int get_value(internal_class_sptr const & class_ptr);
+}
+
+inline namespace v_2 {
+    // batch entry points: one call into the library per batch instead of one per element
+    // case 5 - out[i] = get_value(first[i]) for i in [0, count)
+    A_API void get_values(internal_class_sptr const * first, std::size_t count, int * out);
+
+    // case 5 - internal_class_handle versions of the free functions.
+    // the handle keeps its internal_class alive until destroy_internal_class_handle; using a destroyed handle
+    // throws std::invalid_argument
+    A_API internal_class_handle create_internal_class_handle(int value);
+    // does nothing for a handle that was already destroyed. the library drops its reference to the
+    // internal_class a little later, with the next batch of destroyed handles
+    A_API void destroy_internal_class_handle(internal_class_handle handle) noexcept;
+    A_API int get_value(internal_class_handle handle);
+
+    // case 4 - batch version of use_some_class: element i is described by f1[i] and f2[i],
+    // so the library walks plain arrays instead of making two virtual calls per object
+    A_API void use_some_class_values(int const * f1, int const * f2, std::size_t count);
+
+    // case 5 - ABI-neutral access to the name of internal_class (abi0.md): no allocation for names
+    // of up to string_wrapper::local_capacity chars
+    A_API string_wrapper get_name_an(internal_class_sptr const & class_ptr);
+    // case 5 - the library never allocates: copies the name into the caller's buffer if it has room for it
+    // and returns the size of the name either way. no '\0' is appended
+    A_API std::size_t get_name(internal_class_sptr const & class_ptr, char * buffer, std::size_t capacity);
+
+    // where foo, init and use_some_class write their output.
+    // case 6 - fixed underlying type, new values are only appended
+    enum class output_mode : std::uint32_t {
+        sync_stdout, // default: write to std::cout on the calling thread
+        async,       // queue the record; a library thread hands it to the output sink
+        discard      // drop the output
+    };
+    // receives one complete record, one at a time. async mode calls it from the library output thread, and
+    // from the thread that writes the record once the output thread stopped at exit
+    using output_sink = void (*)(void * context, char const * data, std::size_t size);
+
+    // the output thread starts when async mode is first selected
+    A_API void set_output_mode(output_mode mode);
+    // sink for async mode. nullptr restores the default sink that writes to stdout.
+    // records queued before the call may go to either sink - call flush_output() first if that matters.
+    // once it returns the old sink is not called any more: it waits for a record being delivered to it.
+    // a sink may call it too, then the new sink gets the next record
+    A_API void set_output_sink(output_sink sink, void * context);
+    // waits until every record queued so far was handed to the sink. called from a sink it returns right away
+    A_API void flush_output();
+    // the queue never blocks a caller: records that don't fit are dropped and counted here
+    A_API std::uint64_t dropped_output_records();
+}
+
+inline namespace v_3 {
+    // case 5 - a library-wide registry of internal_class instances by key. lookups from any number of
+    // threads take no lock and write no shared memory except the reference count of the result.
+    // the registry keeps the object alive until it is unregistered or replaced
+
+    // returns false if the key was registered before; the old instance is replaced.
+    // throws std::invalid_argument when value is null
+    A_API bool register_instance(std::uint64_t key, internal_class_sptr value);
+    // returns false if the key was not registered
+    A_API bool unregister_instance(std::uint64_t key);
+    // nullptr if the key is not registered
+    A_API internal_class_sptr find_instance(std::uint64_t key);
+
+    // called once init_async is done, on a library thread. error is null if init succeeded.
+    // must not throw
+    using init_callback = void (*)(void * context, std::exception_ptr error);
+    // runs init(init_params) on a library thread and returns right away. init_params is copied, so the
+    // name doesn't have to outlive the call. callback may be nullptr.
+    // throws only if the call can't be queued; callback is not called then
+    A_API void init_async(params_view init_params, init_callback callback, void * context);
+
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+    // init(first[i]) for i in [0, count) on the calling thread and up to max_threads - 1 library threads
+    // (0: as many as the library has). returns once every element was initialized. each element is initialized
+    // exactly once even if others fail; then the exception of the failed element with the lowest index is rethrown
+    A_API void init_batch(params const * first, std::size_t count, std::size_t max_threads = 0);
+#endif
+
+    // a name stored once in a library-owned pool. two interned_names are equal exactly when
+    // their ids are equal, so comparing them never looks at the characters.
+    // the layout is part of the ABI and must not change
+    struct interned_name {
+        std::uint32_t id = 0; // 0 is the empty name
+    };
+    inline bool operator==(interned_name lhs, interned_name rhs) { return lhs.id == rhs.id; }
+    inline bool operator!=(interned_name lhs, interned_name rhs) { return lhs.id != rhs.id; }
+
+    // the same name always gets the same id. safe to call from any number of threads
+    A_API interned_name intern_name(std::string_view name);
+    // the view stays valid until the process exits. throws std::invalid_argument for an id the pool never gave out
+    A_API std::string_view get_name(interned_name name);
+
+    // case 2 - params for callers that keep many of them: 8 bytes, no allocation per copy.
+    // params and params_view keep working as before
+    struct compact_params {
+        interned_name name;
+        int           age = 0;
+    };
+    // a storage format only: init never compares names, it looks the characters up (get_name) and goes on
+    // like init(params_view). comparing by id is for the callers that compare the names they keep
+    A_API void init(compact_params init_params);
+
+    // the exported entry points, for call statistics. the _v_N values are the compatibility definitions only old
+    // binaries call. an entry point that calls another one counts both.
+    // case 6 - fixed underlying type, new values are only appended
+    enum class entry_point : std::uint32_t {
+        foo_v_0,                            // v_0::foo()
+        foo,
+        init_v_0,                           // v_0::init(v_0::params const &)
+        init,                               // init(params_view)
+        use_some_class,
+        create_internal_class_instance_v_0, // create_internal_class_instance(int)
+        create_internal_class_instance,
+        create_internal_class_instances,
+        get_value,
+        get_values,
+        create_internal_class_handle,
+        destroy_internal_class_handle,
+        get_handle_value,                   // get_value(internal_class_handle)
+        use_some_class_values,
+        get_name_an,
+        get_name_buffer,                    // get_name(internal_class_sptr const &, char *, size_t)
+        set_output_mode,
+        set_output_sink,
+        flush_output,
+        dropped_output_records,
+        register_instance,
+        unregister_instance,
+        find_instance,
+        get_api_table,
+        init_async,
+        init_batch,
+        intern_name,
+        get_interned_name,                  // get_name(interned_name)
+        init_compact,                       // init(compact_params)
+        set_value,
+        get_value_generation,
+        write_params,
+        read_params,
+        init_from_buffer,
+        write_params_mapping,
+        init_from_mapping,
+        init_from_file,
+        set_memory_resource,
+        set_thread_memory_resource,
+        get_memory_resource,
+        create_internal_class_handle_from_instance, // create_internal_class_handle(internal_class_sptr)
+        get_handle_instance,                        // get_instance(internal_class_handle)
+        set_handle_value,                           // set_value(internal_class_handle, int)
+        get_handle_name                             // get_name(internal_class_handle, char *, size_t)
+    };
+
+    // calls of one entry point, summed over all threads
+    struct call_stats {
+        std::uint64_t calls = 0;
+        // latency_histogram[i]: calls that took [2^i, 2^(i+1)) ticks - TSC cycles on x86, nanoseconds elsewhere.
+        // the last bucket takes the longer ones too. all zero unless the library was built with API_UPDATES_CALL_LATENCY
+        std::uint64_t latency_histogram[32] = {};
+    };
+    // out[i] = the statistics of entry_point(i) for i < min(capacity, the number of entry points the library has).
+    // returns that number, or 0 if the library was built without API_UPDATES_CALL_STATS
+    A_API std::size_t get_call_stats(call_stats * out, std::size_t capacity);
+    // nullptr for a value the library doesn't know
+    A_API char const * get_entry_point_name(entry_point entry);
+
+    // case 5 - changes the value of the instance. safe to call while other threads read it
+    A_API void set_value(internal_class_sptr const & class_ptr, int value);
+    A_API void set_value(internal_class_handle handle, int value);
+    // case 5 - a counter the library increments after every change of the value: 0 for a new instance.
+    // it lives as long as the instance. once a reader sees a new generation, get_value returns the new value,
+    // so a wrapper can keep a copy of the value and call get_value only when the generation changed
+    A_API std::atomic<std::uint32_t> const * get_value_generation(internal_class_sptr const & class_ptr);
+
+    // case 5 - a handle for an instance created with create_internal_class_instance, e.g. with a name or from a
+    // memory resource. the handle keeps it alive too. throws std::invalid_argument when instance is null
+    A_API internal_class_handle create_internal_class_handle(internal_class_sptr instance);
+    // case 5 - the instance behind a handle, for the internal_class_sptr functions (get_name_an, register_instance, ...).
+    // it lives as long as the result even after the handle was destroyed
+    A_API internal_class_sptr get_instance(internal_class_handle handle);
+    // case 5 - get_name(internal_class_sptr const &, char *, std::size_t) through a handle
+    A_API std::size_t get_name(internal_class_handle handle, char * buffer, std::size_t capacity);
+
+    // params as a flat buffer that is read in place: the name is a view into the buffer, nothing is parsed or copied.
+    // little-endian, 32-bit fields at fixed offsets:
+    //   0  magic       0x4d525041 ("APRM")
+    //   4  fixed_size  size of the fixed part, where the variable data may start
+    //   8  name_offset from the start of the buffer
+    //   12 name_size
+    //   16 age         (generation 1)
+    // the same rules as for the structs: fields are only appended to the fixed part. a reader ignores fields past
+    // those it knows, and a field past fixed_size gets the default init would use (age 0 for 16-byte buffers)
+    constexpr std::uint32_t params_wire_magic = 0x4d525041;
+
+    // writes init_params into [out, out + capacity) if it fits there and returns the size of the encoding either way.
+    // returns 0 and writes nothing for a name of 4 GiB or more, which the format can't hold
+    A_API std::size_t write_params(params_view init_params, std::byte * out, std::size_t capacity) noexcept;
+    // false if [data, data + size) is not a params buffer. out.name points into the buffer
+    A_API bool read_params(std::byte const * data, std::size_t size, params_view & out) noexcept;
+    // init straight from a buffer. throws std::invalid_argument if it is not a params buffer
+    A_API void init_from_buffer(std::byte const * data, std::size_t size);
+
+    // many params buffers in one mapping, e.g. a config file loaded with init_from_file:
+    //   0  magic       0x53525041 ("APRS")
+    //   4  fixed_size  size of the fixed part, where the offset table starts
+    //   8  count       64 bits
+    //   then count + 1 64-bit offsets from the start of the mapping: record i is the params buffer
+    //   [offset[i], offset[i + 1])
+    // fields are only appended to the fixed part, as in a params buffer
+    constexpr std::uint32_t params_mapping_magic = 0x53525041;
+
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+    // writes the mapping of [first, first + count) into [out, out + capacity) if it fits there
+    // and returns the size of the mapping either way. returns 0 and writes nothing if a name is 4 GiB or more
+    A_API std::size_t write_params_mapping(params const * first, std::size_t count, std::byte * out, std::size_t capacity) noexcept;
+#endif
+    // init of every record of the mapping, on the calling thread and up to max_threads - 1 library threads
+    // like init_batch. the records are read in place and checked only when they are initialized: a record
+    // that is not a params buffer fails with std::invalid_argument, and like in init_batch the other records
+    // are still initialized. a mapping without a valid header throws std::invalid_argument right away
+    A_API void init_from_mapping(void const * data, std::size_t size, std::size_t max_threads = 0);
+    // init_from_mapping of a file mapped into memory. throws std::system_error if the file can't be mapped
+    A_API void init_from_file(char const * path, std::size_t max_threads = 0);
+
+    // where the library allocates what it allocates for a caller: internal_class objects with their control
+    // blocks and names, the copy of the params that init_async queues.
+    // a resource set for a thread wins over the one set for all threads; nullptr unsets it. with neither set
+    // the library uses its own per-thread pools and the global heap. an allocation is freed through the
+    // resource it came from, so the resource must outlive it - objects and pending init_async calls included.
+    // the library's own tables (handles, registry, names, output), the shared state of init_batch and
+    // init_from_mapping (pool threads may release it after the call returned) and string_wrapper keep using
+    // the global heap.
+    // both return the resource set before
+    A_API std::pmr::memory_resource * set_memory_resource(std::pmr::memory_resource * resource) noexcept;
+    A_API std::pmr::memory_resource * set_thread_memory_resource(std::pmr::memory_resource * resource) noexcept;
+    // the resource in effect on the calling thread, nullptr for the library's default
+    A_API std::pmr::memory_resource * get_memory_resource() noexcept;
+
+    // the out-of-line entry points as function pointers: a client looks the table up once and calls through it
+    // instead of through a PLT entry per call.
+    // same rules as for enums in case 6: entries are only appended (a generation adds its entries at the end)
+    // and an entry never changes its type - a changed signature is a new entry
+    struct api_table {
+        std::uint32_t size;    // sizeof(api_table) of the library that filled the table
+        std::uint32_t version; // 3, the generation api_table belongs to
+
+        // generations 0 and 1
+        void                (*init)(params_view);
+        void                (*foo)(int);
+        void                (*use_some_class)(some_class_interface &);
+        internal_class_sptr (*create_internal_class_instance)(int, std::string_view);
+        void                (*create_internal_class_instances)(int const *, std::size_t, internal_class_sptr *);
+        int                 (*get_value)(internal_class_sptr const &);
+        // generation 2
+        void                  (*get_values)(internal_class_sptr const *, std::size_t, int *);
+        internal_class_handle (*create_internal_class_handle)(int);
+        void                  (*destroy_internal_class_handle)(internal_class_handle) noexcept;
+        int                   (*get_handle_value)(internal_class_handle);
+        void                  (*use_some_class_values)(int const *, int const *, std::size_t);
+        string_wrapper        (*get_name_an)(internal_class_sptr const &);
+        std::size_t           (*get_name)(internal_class_sptr const &, char *, std::size_t);
+        // generation 3
+        bool                (*register_instance)(std::uint64_t, internal_class_sptr);
+        bool                (*unregister_instance)(std::uint64_t);
+        internal_class_sptr (*find_instance)(std::uint64_t);
+        void                (*init_async)(params_view, init_callback, void *);
+        void                (*init_batch)(detail::library_params const *, std::size_t, std::size_t);
+        interned_name       (*intern_name)(std::string_view);
+        std::string_view    (*get_interned_name)(interned_name);
+        void                (*init_compact)(compact_params);
+        void                (*set_value)(internal_class_sptr const &, int);
+        std::atomic<std::uint32_t> const * (*get_value_generation)(internal_class_sptr const &);
+        std::size_t         (*write_params)(params_view, std::byte *, std::size_t) noexcept;
+        bool                (*read_params)(std::byte const *, std::size_t, params_view &) noexcept;
+        void                (*init_from_buffer)(std::byte const *, std::size_t);
+        std::size_t         (*write_params_mapping)(detail::library_params const *, std::size_t, std::byte *, std::size_t) noexcept;
+        void                (*init_from_mapping)(void const *, std::size_t, std::size_t);
+        void                (*init_from_file)(char const *, std::size_t);
+        std::pmr::memory_resource * (*set_memory_resource)(std::pmr::memory_resource *) noexcept;
+        std::pmr::memory_resource * (*set_thread_memory_resource)(std::pmr::memory_resource *) noexcept;
+        std::pmr::memory_resource * (*get_memory_resource)() noexcept;
+        internal_class_handle (*create_internal_class_handle_from_instance)(internal_class_sptr);
+        internal_class_sptr   (*get_handle_instance)(internal_class_handle);
+        void                  (*set_handle_value)(internal_class_handle, int);
+        std::size_t           (*get_handle_name)(internal_class_handle, char *, std::size_t);
+    };
+    // the table of generation 3, nullptr for any other version: api_table and get_api_table belong to v_3.
+    // entries are only appended within the generation, so a client reads them only up to size.
+    // a generation that needs a different table adds its own v_N::api_table and v_N::get_api_table, which
+    // accepts N; this one keeps answering the clients built for generation 3. the table is never destroyed
+    A_API api_table const * get_api_table(std::uint32_t version) noexcept;
 }
 
 // inline part inside its own inline namespace
 // case 3 - change inline namespace
-inline namespace inline_v_1 {
+inline namespace API_UPDATES_INLINE_NAMESPACE {
     inline int bar() { return 20; } // case 3 - change any inline part causes the change of inline namespace name
 
     // inline class that can be freely modified without touching the versioning of use_some_class
@@ -55,14 +415,206 @@ inline namespace inline_v_1 {
         int _m2;
     };
 
+    // case 5 - the name as a std::string for clients built with the same ABI as the library
+    inline std::string get_name(internal_class_sptr const & class_ptr)
+    {
+        return std::string(a::get_name_an(class_ptr).str());
+    }
+
+    // case 5 - the name in a per-thread buffer that is reused by the next call on the same thread.
+    // allocates only when a name is longer than any before it on this thread
+    inline std::string_view get_name_view(internal_class_sptr const & class_ptr)
+    {
+        thread_local std::vector<char> buffer(64);
+        std::size_t size = a::get_name(class_ptr, buffer.data(), buffer.size());
+        if (size > buffer.size()) {
+            buffer.resize(size);
+            a::get_name(class_ptr, buffer.data(), buffer.size());
+        }
+        return std::string_view(buffer.data(), size);
+    }
+
+    // case 4 - batch front end for use_some_class. reads f1/f2 of each some_class with direct
+    // (non-virtual) calls and hands them to the library in chunks
+    template<class Iterator>
+    void use_some_class(Iterator first, Iterator last)
+    {
+        static_assert(std::is_same<typename std::iterator_traits<Iterator>::value_type, some_class>::value,
+                      "use_some_class(first, last) reads some_class members directly. "
+                      "use use_some_class(some_class_interface &) for other implementations");
+        constexpr std::size_t chunk_size = 256;
+        int f1[chunk_size];
+        int f2[chunk_size];
+        while (first != last) {
+            std::size_t count = 0;
+            for (; first != last && count < chunk_size; ++first, ++count) {
+                some_class & element = *first;
+                f1[count] = element.some_class::f1();
+                f2[count] = element.some_class::f2();
+            }
+            a::use_some_class_values(f1, f2, count);
+        }
+    }
+
+    // compile-time selection of an API generation (the N of v_N), for clients that want the behavior of
+    // an older generation without going through the compatibility shims the library keeps for old binaries.
+    // both values are inline parts: adding v_N or dropping the shims of v_N requires a new inline namespace
+    constexpr unsigned oldest_api_version  = 0; // the oldest generation whose symbols the library still exports
+    constexpr unsigned current_api_version = 3;
+
+    template<unsigned V>
+    struct api_version {
+        static_assert(V >= oldest_api_version, "the library no longer ships this API generation");
+        static_assert(V <= current_api_version, "this API generation does not exist yet");
+        static constexpr unsigned value = V;
+    };
+
+    // params as they were in generation V. v_0::params is known to the library only (declaring it here would
+    // make a::params ambiguous), so generation 0 gets a struct with the same fields
+    template<unsigned V>
+    struct params_version {
+        using type      = v_1::params;
+        using view_type = v_1::params_view;
+    };
+    template<>
+    struct params_version<0> {
+        struct type      { std::string      name; };
+        struct view_type { std::string_view name; };
+    };
+    template<unsigned V>
+    using params_t = typename params_version<api_version<V>::value>::type;
+    template<unsigned V>
+    using params_view_t = typename params_version<api_version<V>::value>::view_type;
+
+    // init with the behavior of generation V: a direct call of the current out-of-line init,
+    // fields that generation V doesn't have keep their defaults
+    template<unsigned V>
+    void init(params_view_t<V> init_params)
+    {
+        if constexpr (V == 0)
+            a::v_1::init(v_1::params_view{init_params.name});
+        else
+            a::v_1::init(init_params);
+    }
+    template<unsigned V>
+    void init(params_t<V> const & init_params)
+    {
+        if constexpr (V == 0)
+            a::v_1::init(v_1::params_view{init_params.name});
+        else
+            a::v_1::init(v_1::params_view{init_params.name, init_params.age});
+    }
+
+    // the api_table of the generation this header was written for, looked up on the first call.
+    // a library of the same generation built before the last entries were appended fills a shorter table
+    inline api_table const & cached_api_table()
+    {
+        static api_table const * table = a::get_api_table(current_api_version);
+        if (!table || table->size < sizeof(api_table))
+            throw std::runtime_error("the api_updates library is older than its header");
+        return *table;
+    }
+
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+    // the api_table entries that take a params array, without the clients casting it to detail::library_params
+    inline void api_table_init_batch(api_table const & table, params const * first, std::size_t count,
+                                     std::size_t max_threads = 0)
+    {
+        table.init_batch(reinterpret_cast<detail::library_params const *>(first), count, max_threads);
+    }
+
+    inline std::size_t api_table_write_params_mapping(api_table const & table, params const * first, std::size_t count,
+                                                      std::byte * out, std::size_t capacity) noexcept
+    {
+        return table.write_params_mapping(reinterpret_cast<detail::library_params const *>(first), count, out, capacity);
+    }
+#endif
+
+    // init_async with a std::future: get() returns once init is done and rethrows what it threw
+    inline std::future<void> init_async(params_view init_params)
+    {
+        auto promise = std::make_unique<std::promise<void>>();
+        std::future<void> result = promise->get_future();
+        a::init_async(init_params, [](void * context, std::exception_ptr error) {
+            std::unique_ptr<std::promise<void>> done(static_cast<std::promise<void> *>(context));
+            if (error)
+                done->set_exception(error);
+            else
+                done->set_value();
+        }, promise.get());
+        promise.release(); // owned by the callback now
+        return result;
+    }
+
     // case 5 - If you want to expose the functionality as a class
     // provide a class that redirects calls to free functions
     class exposed_internal_class{
     public:
-        exposed_internal_class(int value) : _impl(a::create_internal_class_instance(value)){}
-        int get_value() { return a::get_value(_impl); } // redirect call to a free function
+        exposed_internal_class(int value, std::string_view name = {})
+            : _impl(a::create_internal_class_instance(value, name)), _generation(a::get_value_generation(_impl)),
+              _cache(pack(0, value)) {}
+        exposed_internal_class(exposed_internal_class const & other)
+            : _impl(other._impl), _generation(other._generation), _cache(other._cache.load(std::memory_order_relaxed)) {}
+        exposed_internal_class & operator=(exposed_internal_class const & other)
+        {
+            _impl       = other._impl;
+            _generation = other._generation;
+            _cache.store(other._cache.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+        // a load and a compare while the value doesn't change, a call to a free function after it did
+        int get_value() const
+        {
+            std::uint32_t generation = _generation->load(std::memory_order_acquire);
+            std::uint64_t cache = _cache.load(std::memory_order_relaxed);
+            if (static_cast<std::uint32_t>(cache >> 32) == generation)
+                return static_cast<int>(static_cast<std::uint32_t>(cache));
+            int value = a::get_value(_impl); // redirect call to a free function
+            _cache.store(pack(generation, value), std::memory_order_relaxed);
+            return value;
+        }
+        void set_value(int value) { a::set_value(_impl, value); }
+        std::string get_name() const { return a::get_name(_impl); }
+    private:
+        static std::uint64_t pack(std::uint32_t generation, int value)
+        {
+            return std::uint64_t(generation) << 32 | static_cast<std::uint32_t>(value);
+        }
+
+        internal_class_sptr                _impl;
+        std::atomic<std::uint32_t> const * _generation;
+        // the generation in the high half, the value it belongs to in the low half. shared by threads that
+        // read through the same wrapper
+        mutable std::atomic<std::uint64_t> _cache;
+    };
+
+    // case 5 - the same wrapper on top of internal_class_handle. it owns the handle; copies of handle()
+    // can be read from any number of threads without any shared cache line being written
+    class light_exposed_internal_class{
+    public:
+        light_exposed_internal_class(int value, std::string_view name = {})
+            : _handle(name.empty() ? a::create_internal_class_handle(value)
+                                   : a::create_internal_class_handle(a::create_internal_class_instance(value, name))){}
+        light_exposed_internal_class(light_exposed_internal_class && other) noexcept : _handle(std::exchange(other._handle, {})){}
+        light_exposed_internal_class & operator=(light_exposed_internal_class && other) noexcept
+        {
+            std::swap(_handle, other._handle);
+            return *this;
+        }
+        ~light_exposed_internal_class() { a::destroy_internal_class_handle(_handle); }
+        int get_value() const { return a::get_value(_handle); } // redirect call to a free function
+        void set_value(int value) { a::set_value(_handle, value); }
+        std::string get_name() const
+        {
+            std::string name(a::get_name(_handle, nullptr, 0), '\0');
+            a::get_name(_handle, name.data(), name.size());
+            return name;
+        }
+        // the object as an internal_class_sptr, e.g. for register_instance
+        internal_class_sptr instance() const { return a::get_instance(_handle); }
+        internal_class_handle handle() const { return _handle; }
     private:
-        internal_class_sptr  _impl;
+        internal_class_handle _handle;
     };
 }
 
@@ -0,0 +1,87 @@
+#ifndef API_UPDATES_CORO_HPP
+#define API_UPDATES_CORO_HPP
+#include <api_updates/api.hpp>
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace a{
+
+// C++20 awaitables on top of the C++17 API. the library doesn't depend on this header: it is inline code only
+// and, like the inline part of api.hpp (case 3), it lives in its own inline namespace whose name must change
+// with any change in it
+inline namespace coro_v_2 {
+    // resumes the coroutine right on the thread that completed the operation - for init_co a library thread.
+    // only for code after co_await that is short and doesn't block: it holds up that library thread
+    struct inline_executor {
+        template<class F>
+        void execute(F && f) const { std::forward<F>(f)(); }
+    };
+
+    // co_await init_co(params, executor) - init on a library thread. the coroutine is resumed through
+    // executor.execute(f): any executor with that member (asio executors have it) gets the coroutine back
+    // on its own threads. nothing is allocated besides what init_async needs.
+    // the executor is required: the library can't know the caller's, and resuming on the library thread
+    // that ran init (inline_executor) has to be asked for
+    template<class Executor>
+    class init_awaitable {
+    public:
+        init_awaitable(params_view init_params, Executor executor) : _params(init_params), _executor(std::move(executor)) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> caller)
+        {
+            _caller = caller;
+            // the coroutine may already run on another thread when init_async returns: don't touch *this after it
+            a::init_async(_params, &completed, this);
+        }
+        void await_resume() const
+        {
+            if (_error)
+                std::rethrow_exception(_error);
+        }
+
+    private:
+        static void completed(void * context, std::exception_ptr error)
+        {
+            auto * self = static_cast<init_awaitable *>(context);
+            self->_error = error;
+            std::coroutine_handle<> caller = self->_caller;
+            // the resumed coroutine may destroy *this while execute is still running on this thread
+            Executor executor = std::move(self->_executor);
+            executor.execute([caller] { caller.resume(); });
+        }
+
+        params_view             _params;
+        Executor                _executor;
+        std::coroutine_handle<> _caller;
+        std::exception_ptr      _error;
+    };
+
+    template<class Executor>
+    init_awaitable<Executor> init_co(params_view init_params, Executor executor)
+    {
+        return {init_params, std::move(executor)};
+    }
+
+    // co_await get_value_co(handle) - reading through a handle never blocks, so the coroutine never suspends:
+    // no thread hop, no allocation. throws std::invalid_argument for a destroyed handle, like get_value
+    class get_value_awaitable {
+    public:
+        explicit get_value_awaitable(internal_class_handle handle) : _handle(handle) {}
+
+        bool await_ready() const noexcept { return true; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        int  await_resume() const { return a::get_value(_handle); }
+
+    private:
+        internal_class_handle _handle;
+    };
+
+    inline get_value_awaitable get_value_co(internal_class_handle handle) { return get_value_awaitable(handle); }
+}
+
+}
+#endif
+#endif //API_UPDATES_CORO_HPP
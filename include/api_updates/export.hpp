@@ -0,0 +1,12 @@
+#ifndef API_UPDATES_EXPORT_HPP
+#define API_UPDATES_EXPORT_HPP
+
+// marks the public API of the library. with API_UPDATES_HIDDEN_VISIBILITY the library is built with
+// hidden visibility by default and only the names marked A_API are exported
+#if defined(__GNUC__) || defined(__clang__)
+#  define A_API __attribute__((visibility("default")))
+#else
+#  define A_API
+#endif
+
+#endif //API_UPDATES_EXPORT_HPP
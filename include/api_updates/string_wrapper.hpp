@@ -0,0 +1,104 @@
+#ifndef API_UPDATES_STRING_WRAPPER_HPP
+#define API_UPDATES_STRING_WRAPPER_HPP
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace a{
+
+// string_wrapper crosses the library boundary (see abi0.md), so its layout is part of the ABI.
+// it is all inline code, so it has its own inline namespace (case 3). any change of the layout or of
+// the member functions needs a new namespace name and new functions that return the new type
+inline namespace string_wrapper_v_1 {
+    // owns a string and returns string_view on request. strings of up to local_capacity chars are stored
+    // inline, so returning a typical name costs no allocation. the data is always '\0'-terminated
+    class string_wrapper {
+    public:
+        static constexpr std::size_t local_capacity = 23;
+
+        string_wrapper() noexcept : _size(0) { _local[0] = '\0'; }
+        string_wrapper(std::string_view str) : string_wrapper() { assign(str); }
+        string_wrapper(const char * str) : string_wrapper(std::string_view(str)) {}
+        string_wrapper(string_wrapper const & other) : string_wrapper(other.str()) {}
+        string_wrapper(string_wrapper && other) noexcept { steal(other); }
+        ~string_wrapper() { release(); }
+
+        string_wrapper & operator=(string_wrapper const & other)
+        {
+            assign(other.str());
+            return *this;
+        }
+        string_wrapper & operator=(string_wrapper && other) noexcept
+        {
+            if (this != &other) {
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+        string_wrapper & operator=(const char * str)
+        {
+            assign(str);
+            return *this;
+        }
+        string_wrapper & operator=(std::string_view str)
+        {
+            assign(str);
+            return *this;
+        }
+
+        operator std::string_view() const { return str(); }
+        std::string_view str() const { return std::string_view(data(), _size); }
+        const char * data() const { return is_local() ? _local : _heap; }
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        bool is_local() const { return _size <= local_capacity; }
+
+        // str may point into this object
+        void assign(std::string_view str)
+        {
+            char * old_heap = is_local() ? nullptr : _heap;
+            if (str.size() <= local_capacity) {
+                std::memmove(_local, str.data(), str.size());
+                _local[str.size()] = '\0';
+            } else {
+                char * buffer = new char[str.size() + 1];
+                std::memcpy(buffer, str.data(), str.size());
+                buffer[str.size()] = '\0';
+                _heap = buffer;
+            }
+            _size = str.size();
+            delete[] old_heap;
+        }
+
+        void steal(string_wrapper & other) noexcept
+        {
+            _size = other._size;
+            if (other.is_local())
+                std::memcpy(_local, other._local, _size + 1);
+            else
+                _heap = other._heap;
+            other._size = 0;
+            other._local[0] = '\0';
+        }
+
+        void release() noexcept
+        {
+            if (!is_local())
+                delete[] _heap;
+        }
+
+        std::size_t _size;
+        union {
+            char   _local[local_capacity + 1];
+            char * _heap; // size() + 1 bytes
+        };
+    };
+    static_assert(sizeof(string_wrapper) == sizeof(std::size_t) + string_wrapper::local_capacity + 1,
+                  "string_wrapper layout is part of the ABI");
+}
+
+}
+#endif //API_UPDATES_STRING_WRAPPER_HPP
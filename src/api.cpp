@@ -1,42 +1,67 @@
 #include <api_updates/api.hpp>
-#include <iostream>
+#include "call_stats.hpp"
+#include "internal_class.hpp"
+#include "memory_resource.hpp"
+#include "output.hpp"
+#include "pool_allocator.hpp"
+#include "probes.hpp"
 namespace a {
 
-class internal_class {
-public:
-    internal_class(int value) : _value(value){}
-    int get_value() const { return _value; };
-private:
-    int _value;
-};
+namespace
+{
+    void print_some_class(int f1, int f2)
+    {
+        detail::output_line() << "hello from use_some_class. arg.f1(): " << f1 << " arg.f2(): " << f2 << "\n";
+    }
+}
 
 inline namespace v_0
 {
     // case 1: add an implementation of a function with a new argument
     void foo(int arg)
     {
-        std::cout << "hello from foo with arg: " << arg << "\n";
+        API_UPDATES_COUNT_CALL(foo);
+        API_UPDATES_TRACE(foo, 0, arg);
+        detail::output_line() << "hello from foo with arg: " << arg << "\n";
     }
 
-    // case 1: change the old function implementation to call a new one or keep the existing implementation as is if necessary
-    void foo()
-    {
-        foo(0);
-    }
+    // case 1: the old foo() calls the new one. it is generated from src/compat_entry_points.def
+    // in api_compatibility.cpp
     // case 4- non-inline part implementation
     void use_some_class(some_class_interface & arg)
     {
-        std::cout << "hello from use_some_class. arg.f1(): " << arg.f1() << " arg.f2(): " << arg.f2() << "\n";
+        API_UPDATES_COUNT_CALL(use_some_class);
+        API_UPDATES_TRACE(use_some_class, 0, 0);
+        int f1 = arg.f1();
+        int f2 = arg.f2();
+        print_some_class(f1, f2);
     }
 
     // case 5 - functions implementation
-    internal_class_sptr create_internal_class_instance(int value)
+    internal_class_sptr create_internal_class_instance(int value, std::string_view name)
     {
-        return std::make_shared<internal_class>(value);
+        API_UPDATES_COUNT_CALL(create_internal_class_instance);
+        API_UPDATES_TRACE(create_internal_class_instance, 0, value);
+        // the object and its control block come from the caller's resource, else from a per-thread free list
+        if (std::pmr::memory_resource * resource = detail::current_resource())
+            return std::allocate_shared<internal_class>(std::pmr::polymorphic_allocator<internal_class>(resource), value, name);
+        return std::allocate_shared<internal_class>(detail::pool_allocator<internal_class>(), value, name,
+                                                    internal_class::allocator_type(detail::heap_resource));
+    }
+
+    // case 1: create_internal_class_instance(int) is generated like foo()
+
+    void create_internal_class_instances(int const * values, std::size_t count, internal_class_sptr * out)
+    {
+        API_UPDATES_COUNT_CALL(create_internal_class_instances);
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = create_internal_class_instance(values[i], {});
     }
 
     int get_value(internal_class_sptr const & class_ptr)
     {
+        API_UPDATES_COUNT_CALL(get_value);
+        API_UPDATES_TRACE(get_value, 0, class_ptr.get());
         return class_ptr->get_value();
     }
 }
@@ -44,10 +69,65 @@ inline namespace v_0
 // case 2: update version namespace
 inline namespace v_1
 {
+#if !defined(API_UPDATES_BUNDLED)
+    // init(params const &) became inline. keep emitting it for clients that were linked
+    // against the out-of-line version
+    __attribute__((used)) static void (*const keep_init_params_symbol)(params const &) = &init;
+#endif
+
     // case 2: change the implementation to use a new struct member
-    void init(params const &init_params)
+    void init(params_view init_params)
+    {
+        API_UPDATES_COUNT_CALL(init);
+        API_UPDATES_TRACE(init, 1, init_params.age);
+        detail::output_line() << "hello from init:  name: " << init_params.name << " age: " << init_params.age << "\n";
+    }
+}
+
+inline namespace v_2
+{
+    void get_values(internal_class_sptr const * first, std::size_t count, int * out)
+    {
+        API_UPDATES_COUNT_CALL(get_values);
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = first[i]->get_value();
+    }
+
+    void use_some_class_values(int const * f1, int const * f2, std::size_t count)
+    {
+        API_UPDATES_COUNT_CALL(use_some_class_values);
+        for (std::size_t i = 0; i < count; ++i)
+            print_some_class(f1[i], f2[i]);
+    }
+
+    string_wrapper get_name_an(internal_class_sptr const & class_ptr)
     {
-        std::cout << "hello from init:  name: " << init_params.name << " age: " << init_params.age << "\n";
+        API_UPDATES_COUNT_CALL(get_name_an);
+        return string_wrapper(class_ptr->get_name());
     }
+
+    std::size_t get_name(internal_class_sptr const & class_ptr, char * buffer, std::size_t capacity)
+    {
+        API_UPDATES_COUNT_CALL(get_name_buffer);
+        std::string_view name = class_ptr->get_name();
+        if (name.size() <= capacity)
+            name.copy(buffer, name.size());
+        return name.size();
+    }
+}
+
+inline namespace v_3
+{
+    void set_value(internal_class_sptr const & class_ptr, int value)
+    {
+        API_UPDATES_COUNT_CALL(set_value);
+        class_ptr->set_value(value);
+    }
+
+    std::atomic<std::uint32_t> const * get_value_generation(internal_class_sptr const & class_ptr)
+    {
+        API_UPDATES_COUNT_CALL(get_value_generation);
+        return &class_ptr->get_generation();
+    }
+}
 }
-}
\ No newline at end of file
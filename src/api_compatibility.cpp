@@ -1,4 +1,6 @@
 #include <api_updates/api.hpp>
+#include "compat_shims.hpp"
+#include "params_conversion.hpp"
 namespace a{
 
 inline namespace v_0{
@@ -6,14 +8,19 @@ inline namespace v_0{
     struct params{
         std::string name;
     };
-    // case 2: function in the old namespace fills up a new struct and calls a new function
-    void init(params const & init_params)
-    {
-        v_1::params new_params;
-        new_params.name = init_params.name;
-        // don't set a new field if the default is good enough
+}
 
-        // call a new function
-        init(new_params);
-    }
-}}
\ No newline at end of file
+namespace detail {
+    // case 2: how the fields of the old struct map onto the next generation. the new field (age) isn't mapped,
+    // so it keeps its default. the next generation is a non-owning view, so old clients don't pay for a copy of the name.
+    // when a new generation comes, it declares its own mapping and convert<> goes from v_0 straight to it
+    template<>
+    struct next_generation<v_0::params> {
+        using type   = v_1::params_view;
+        using fields = field_list<field_map<&v_0::params::name, &v_1::params_view::name>>;
+    };
+}
+
+// case 1 and case 2: the old functions call the new ones. generated from the manifest
+#include "compat_entry_points.def"
+}
@@ -0,0 +1,74 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+namespace a {
+
+namespace {
+// the entries that take the params array as the opaque detail::library_params
+void init_batch_entry(detail::library_params const * first, std::size_t count, std::size_t max_threads)
+{
+    init_batch(reinterpret_cast<params const *>(first), count, max_threads);
+}
+
+std::size_t write_params_mapping_entry(detail::library_params const * first, std::size_t count, std::byte * out,
+                                       std::size_t capacity) noexcept
+{
+    return write_params_mapping(reinterpret_cast<params const *>(first), count, out, capacity);
+}
+
+// constant initialized: the table is filled when the library is loaded, not on the first lookup.
+// every entry is the exported function itself. a CPU-specific variant of a batch entry would be picked here,
+// with the table then filled by a load-time initializer or an ifunc resolver (__builtin_cpu_supports). none
+// is: a prototype AVX2 gather version of get_values took 7.2 us per 10000 objects against 6.9 us for the loop,
+// the loads of the objects themselves dominate
+constexpr api_table table = {
+    sizeof(api_table),
+    current_api_version,
+    static_cast<void (*)(params_view)>(&init),
+    &foo,
+    &use_some_class,
+    &create_internal_class_instance,
+    &create_internal_class_instances,
+    static_cast<int (*)(internal_class_sptr const &)>(&get_value),
+    &get_values,
+    static_cast<internal_class_handle (*)(int)>(&create_internal_class_handle),
+    &destroy_internal_class_handle,
+    static_cast<int (*)(internal_class_handle)>(&get_value),
+    &use_some_class_values,
+    &get_name_an,
+    static_cast<std::size_t (*)(internal_class_sptr const &, char *, std::size_t)>(&get_name),
+    &register_instance,
+    &unregister_instance,
+    &find_instance,
+    static_cast<void (*)(params_view, init_callback, void *)>(&init_async),
+    &init_batch_entry,
+    &intern_name,
+    static_cast<std::string_view (*)(interned_name)>(&get_name),
+    static_cast<void (*)(compact_params)>(&init),
+    static_cast<void (*)(internal_class_sptr const &, int)>(&set_value),
+    &get_value_generation,
+    &write_params,
+    &read_params,
+    &init_from_buffer,
+    &write_params_mapping_entry,
+    &init_from_mapping,
+    &init_from_file,
+    &set_memory_resource,
+    &set_thread_memory_resource,
+    &get_memory_resource,
+    static_cast<internal_class_handle (*)(internal_class_sptr)>(&create_internal_class_handle),
+    &get_instance,
+    static_cast<void (*)(internal_class_handle, int)>(&set_value),
+    static_cast<std::size_t (*)(internal_class_handle, char *, std::size_t)>(&get_name),
+};
+}
+
+inline namespace v_3
+{
+    api_table const * get_api_table(std::uint32_t version) noexcept
+    {
+        API_UPDATES_COUNT_CALL(get_api_table);
+        // api_table only exists in v_3, so it only describes generation 3 (see api.hpp)
+        return version == current_api_version ? &table : nullptr;
+    }
+}
+}
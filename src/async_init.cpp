@@ -0,0 +1,62 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include "batch.hpp"
+#include "memory_resource.hpp"
+#include "thread_pool.hpp"
+#include <exception>
+#include <string>
+namespace a {
+
+namespace {
+// what init_async queues: the params with a copy of the name, from the caller's resource
+struct pending_init {
+    pending_init(params_view init_params, init_callback done, void * done_context, std::pmr::memory_resource * resource)
+        : name(init_params.name, resource), age(init_params.age), callback(done), context(done_context) {}
+
+    // deletes this
+    void run() noexcept
+    {
+        std::exception_ptr error;
+        try {
+            init(params_view{name, age});
+        } catch (...) {
+            error = std::current_exception();
+        }
+        init_callback done = callback;
+        void * done_context = context;
+        detail::delete_object(name.get_allocator().resource(), this);
+        if (done)
+            done(done_context, error);
+    }
+
+    std::pmr::string name;
+    int              age;
+    init_callback    callback;
+    void *           context;
+};
+}
+
+inline namespace v_3
+{
+    void init_async(params_view init_params, init_callback callback, void * context)
+    {
+        API_UPDATES_COUNT_CALL(init_async);
+        // the caller's view may dangle as soon as this returns. the copy comes from the caller's resource,
+        // and the task holds a single pointer, so std::function doesn't allocate for it
+        std::pmr::memory_resource * resource = detail::resource_or_heap();
+        auto * pending = detail::new_object<pending_init>(resource, init_params, callback, context, resource);
+        try {
+            detail::thread_pool::instance().submit([pending] { pending->run(); });
+        } catch (...) {
+            detail::delete_object(resource, pending);
+            throw;
+        }
+    }
+
+    void init_batch(params const * first, std::size_t count, std::size_t max_threads)
+    {
+        API_UPDATES_COUNT_CALL(init_batch);
+        detail::run_batch([first](std::size_t index) { init(first[index]); }, count, max_threads);
+    }
+}
+}
@@ -0,0 +1,169 @@
+#ifndef API_UPDATES_BATCH_HPP
+#define API_UPDATES_BATCH_HPP
+#include "memory_resource.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace a {
+namespace detail {
+
+// init(i) for every element i of a batch. the batch is split into one contiguous range per participating
+// thread. a thread takes elements from the front of its own range; when that is empty it steals the back half
+// of the largest range left.
+// begin and end share one atomic word, so taking and stealing are single compare-exchanges
+template<class Init>
+class batch {
+public:
+    batch(Init init, std::size_t offset, std::uint32_t count, std::size_t parts, std::pmr::memory_resource * resource)
+        : _init(std::move(init)), _offset(offset), _count(count), _ranges(parts, resource)
+    {
+        for (std::size_t i = 0; i < parts; ++i)
+            _ranges[i].bounds.store(pack(count * i / parts, count * (i + 1) / parts), std::memory_order_relaxed);
+    }
+
+    // returns once no work is left for thread `part`; other threads may still be busy
+    void work(std::size_t part)
+    {
+        std::uint32_t finished = 0;
+        do {
+            std::uint32_t begin, end;
+            while (take(part, begin, end)) {
+                for (std::uint32_t index = begin; index < end; ++index) {
+                    try {
+                        _init(_offset + index);
+                    } catch (...) {
+                        fail(index, std::current_exception());
+                    }
+                }
+                finished += end - begin;
+            }
+        } while (steal(part));
+        if (finished && _finished.fetch_add(finished, std::memory_order_acq_rel) + finished == _count) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.notify_all();
+        }
+    }
+
+    // the exception of the failed element with the lowest index, once every element was initialized
+    std::exception_ptr wait()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _finished.load(std::memory_order_acquire) == _count; });
+        return _error;
+    }
+
+private:
+    struct alignas(64) range {
+        std::atomic<std::uint64_t> bounds{0};
+    };
+
+    static std::uint64_t pack(std::uint64_t begin, std::uint64_t end) { return begin << 32 | end; }
+    static std::uint32_t begin_of(std::uint64_t bounds) { return static_cast<std::uint32_t>(bounds >> 32); }
+    static std::uint32_t end_of(std::uint64_t bounds) { return static_cast<std::uint32_t>(bounds); }
+
+    // a few elements per compare-exchange; the chunk stays small so that the rest can still be stolen
+    bool take(std::size_t part, std::uint32_t & begin, std::uint32_t & end)
+    {
+        constexpr std::uint32_t max_chunk = 16;
+        auto & bounds = _ranges[part].bounds;
+        std::uint64_t current = bounds.load(std::memory_order_relaxed);
+        do {
+            std::uint32_t size = end_of(current) - begin_of(current);
+            if (size == 0)
+                return false;
+            begin = begin_of(current);
+            end   = begin + std::min(max_chunk, (size + 3) / 4);
+        } while (!bounds.compare_exchange_weak(current, pack(end, end_of(current)),
+                                               std::memory_order_acquire, std::memory_order_relaxed));
+        return true;
+    }
+
+    // moves the back half of the largest range into the (empty) range of `part`. false if nothing is left
+    bool steal(std::size_t part)
+    {
+        for (;;) {
+            std::size_t   victim = part;
+            std::uint32_t largest = 0;
+            for (std::size_t i = 0; i < _ranges.size(); ++i) {
+                std::uint64_t bounds = _ranges[i].bounds.load(std::memory_order_relaxed);
+                if (end_of(bounds) - begin_of(bounds) > largest) {
+                    largest = end_of(bounds) - begin_of(bounds);
+                    victim  = i;
+                }
+            }
+            if (largest == 0)
+                return false;
+            auto & bounds = _ranges[victim].bounds;
+            std::uint64_t current = bounds.load(std::memory_order_relaxed);
+            std::uint32_t size = end_of(current) - begin_of(current);
+            if (size == 0)
+                continue;
+            std::uint32_t middle = end_of(current) - (size + 1) / 2;
+            if (bounds.compare_exchange_strong(current, pack(begin_of(current), middle), std::memory_order_acq_rel)) {
+                _ranges[part].bounds.store(pack(middle, end_of(current)), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    void fail(std::uint32_t index, std::exception_ptr error)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (index < _error_index) {
+            _error_index = index;
+            _error       = error;
+        }
+    }
+
+    Init                       _init;
+    std::size_t                _offset;
+    std::uint32_t              _count;
+    std::pmr::vector<range>    _ranges;
+    std::atomic<std::uint32_t> _finished{0};
+    std::mutex                 _mutex;
+    std::condition_variable    _done;
+    std::uint32_t              _error_index = std::numeric_limits<std::uint32_t>::max();
+    std::exception_ptr         _error;
+};
+
+// runs init(i) for i in [0, count) on the calling thread and up to max_threads - 1 pool threads
+// (0: the whole pool), then rethrows the exception of the failed element with the lowest index
+template<class Init>
+void run_batch(Init const & init, std::size_t count, std::size_t max_threads)
+{
+    auto & pool = thread_pool::instance();
+    std::size_t threads = max_threads ? std::min(max_threads, pool.size() + 1) : pool.size() + 1;
+    std::exception_ptr error;
+    // ranges are indexed with 32 bits. a larger batch goes in slices
+    constexpr std::size_t max_slice = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t offset = 0; offset < count; offset += max_slice) {
+        auto slice = static_cast<std::uint32_t>(std::min(count - offset, max_slice));
+        std::size_t parts = std::min<std::size_t>(threads, slice);
+        // helpers the pool starts late find no work left and only drop their reference, possibly after
+        // run_batch returned: the state comes from the global heap, not from the caller's resource
+        auto state = std::allocate_shared<batch<Init>>(std::pmr::polymorphic_allocator<batch<Init>>(heap_resource),
+                                                       init, offset, slice, parts, heap_resource);
+        for (std::size_t part = 1; part < parts; ++part)
+            pool.submit([state, part] { state->work(part); });
+        // the caller works too, so the batch finishes even when every pool thread is busy
+        state->work(0);
+        if (std::exception_ptr slice_error = state->wait(); slice_error && !error)
+            error = slice_error;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+}
+}
+#endif //API_UPDATES_BATCH_HPP
@@ -0,0 +1,172 @@
+#include "call_stats.hpp"
+#include <mutex>
+namespace a {
+
+namespace {
+char const * const entry_point_names[] = {
+    "v_0::foo()",
+    "foo(int)",
+    "v_0::init(v_0::params const &)",
+    "init(params_view)",
+    "use_some_class(some_class_interface &)",
+    "create_internal_class_instance(int)",
+    "create_internal_class_instance(int, std::string_view)",
+    "create_internal_class_instances",
+    "get_value(internal_class_sptr const &)",
+    "get_values",
+    "create_internal_class_handle",
+    "destroy_internal_class_handle",
+    "get_value(internal_class_handle)",
+    "use_some_class_values",
+    "get_name_an",
+    "get_name(internal_class_sptr const &, char *, size_t)",
+    "set_output_mode",
+    "set_output_sink",
+    "flush_output",
+    "dropped_output_records",
+    "register_instance",
+    "unregister_instance",
+    "find_instance",
+    "get_api_table",
+    "init_async",
+    "init_batch",
+    "intern_name",
+    "get_name(interned_name)",
+    "init(compact_params)",
+    "set_value",
+    "get_value_generation",
+    "write_params",
+    "read_params",
+    "init_from_buffer",
+    "write_params_mapping",
+    "init_from_mapping",
+    "init_from_file",
+    "set_memory_resource",
+    "set_thread_memory_resource",
+    "get_memory_resource",
+    "create_internal_class_handle(internal_class_sptr)",
+    "get_instance(internal_class_handle)",
+    "set_value(internal_class_handle, int)",
+    "get_name(internal_class_handle, char *, size_t)",
+};
+static_assert(sizeof(entry_point_names) / sizeof(entry_point_names[0]) == detail::entry_point_count,
+              "every entry_point needs a name");
+
+#if defined(API_UPDATES_CALL_STATS)
+// the blocks of running threads, and what exited threads counted
+class call_registry {
+public:
+    void attach(detail::thread_calls & calls)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        calls.next = _head;
+        if (_head)
+            _head->prev = &calls;
+        _head = &calls;
+    }
+
+    void detach(detail::thread_calls & calls)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        add_to(_retired, calls);
+        (calls.prev ? calls.prev->next : _head) = calls.next;
+        if (calls.next)
+            calls.next->prev = calls.prev;
+    }
+
+    void snapshot(call_stats * out, std::size_t count)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = _retired[i];
+        for (detail::thread_calls * calls = _head; calls; calls = calls->next)
+            add_to(out, *calls, count);
+    }
+
+private:
+    static void add_to(call_stats * out, detail::thread_calls const & calls, std::size_t count = detail::entry_point_count)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i].calls += calls.calls[i].load(std::memory_order_relaxed);
+#if defined(API_UPDATES_CALL_LATENCY)
+            for (std::size_t bucket = 0; bucket < detail::latency_buckets; ++bucket)
+                out[i].latency_histogram[bucket] += calls.latency[i][bucket].load(std::memory_order_relaxed);
+#endif
+        }
+    }
+
+    std::mutex             _mutex;
+    detail::thread_calls * _head = nullptr;
+    call_stats             _retired[detail::entry_point_count];
+};
+
+// never destroyed: calls may come from static destructors of the client
+call_registry & registry()
+{
+    static call_registry & instance = *new call_registry;
+    return instance;
+}
+
+// calls made on a thread after its block was detached (from thread_local destructors). shared by all threads,
+// so such calls may be lost, never counted twice
+detail::thread_calls & late_calls()
+{
+    static detail::thread_calls & calls = [] () -> detail::thread_calls & {
+        auto * calls = new detail::thread_calls;
+        registry().attach(*calls);
+        return *calls;
+    }();
+    return calls;
+}
+
+// the thread's block, detached and folded into the totals of exited threads at thread exit
+struct thread_calls_owner {
+    thread_calls_owner() { registry().attach(calls); }
+    ~thread_calls_owner()
+    {
+        registry().detach(calls);
+        detail::current_thread_calls = &late_calls();
+    }
+    detail::thread_calls calls;
+};
+#endif
+}
+
+#if defined(API_UPDATES_CALL_STATS)
+namespace detail {
+#if defined(__GNUC__)
+    __thread __attribute__((tls_model("initial-exec"))) thread_calls * current_thread_calls = nullptr;
+#else
+    thread_local thread_calls * current_thread_calls = nullptr;
+#endif
+
+    thread_calls & register_this_thread_calls()
+    {
+        thread_local thread_calls_owner owner;
+        current_thread_calls = &owner.calls;
+        return owner.calls;
+    }
+}
+#endif
+
+inline namespace v_3
+{
+    std::size_t get_call_stats(call_stats * out, std::size_t capacity)
+    {
+#if defined(API_UPDATES_CALL_STATS)
+        registry().snapshot(out, capacity < detail::entry_point_count ? capacity : detail::entry_point_count);
+        return detail::entry_point_count;
+#else
+        static_cast<void>(out);
+        static_cast<void>(capacity);
+        return 0;
+#endif
+    }
+
+    char const * get_entry_point_name(entry_point entry)
+    {
+        auto index = static_cast<std::size_t>(entry);
+        return index < detail::entry_point_count ? entry_point_names[index] : nullptr;
+    }
+}
+}
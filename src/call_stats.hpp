@@ -0,0 +1,105 @@
+#ifndef API_UPDATES_CALL_STATS_HPP
+#define API_UPDATES_CALL_STATS_HPP
+#include <api_updates/api.hpp>
+#include <atomic>
+#include <cstdint>
+#if defined(API_UPDATES_CALL_LATENCY) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// API_UPDATES_COUNT_CALL(name) at the top of an exported function counts the call in a block of counters
+// owned by the calling thread - no shared cache line is written. with API_UPDATES_CALL_LATENCY it also
+// puts the duration of the call into a histogram. without API_UPDATES_CALL_STATS it compiles to nothing
+#if defined(API_UPDATES_CALL_STATS)
+#define API_UPDATES_COUNT_CALL(name) ::a::detail::counted_call api_updates_counted_call(::a::entry_point::name)
+#else
+#define API_UPDATES_COUNT_CALL(name) static_cast<void>(0)
+#endif
+
+namespace a {
+namespace detail {
+
+constexpr std::size_t entry_point_count = static_cast<std::size_t>(entry_point::get_handle_name) + 1;
+constexpr std::size_t latency_buckets   = sizeof(call_stats::latency_histogram) / sizeof(std::uint64_t);
+
+#if defined(API_UPDATES_CALL_STATS)
+// written by the owning thread only (a load and a store, no read-modify-write), read by get_call_stats
+struct alignas(64) thread_calls {
+    std::atomic<std::uint64_t> calls[entry_point_count] = {};
+#if defined(API_UPDATES_CALL_LATENCY)
+    std::atomic<std::uint64_t> latency[entry_point_count][latency_buckets] = {};
+#endif
+    thread_calls * next = nullptr;
+    thread_calls * prev = nullptr;
+};
+
+// the block of the calling thread, null until its first counted call (call_stats.cpp). like thread_resource
+// (memory_resource.hpp) a plain pointer: a single load, no call. hidden, so the library reads it directly
+// and not through the PLT or a TLS descriptor
+#if defined(__GNUC__)
+extern __thread __attribute__((tls_model("initial-exec"), visibility("hidden"))) thread_calls * current_thread_calls;
+#else
+extern thread_local thread_calls * current_thread_calls;
+#endif
+
+// registers the block of the calling thread on its first call
+#if defined(__GNUC__)
+__attribute__((visibility("hidden"), noinline, cold))
+#endif
+thread_calls & register_this_thread_calls();
+
+inline thread_calls & this_thread_calls()
+{
+    if (thread_calls * calls = current_thread_calls)
+        return *calls;
+    return register_this_thread_calls();
+}
+
+inline void add(std::atomic<std::uint64_t> & counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+class counted_call {
+public:
+    explicit counted_call(entry_point entry) : _calls(this_thread_calls()), _entry(static_cast<std::size_t>(entry))
+    {
+        add(_calls.calls[_entry]);
+#if defined(API_UPDATES_CALL_LATENCY)
+        _start = ticks();
+#endif
+    }
+#if defined(API_UPDATES_CALL_LATENCY)
+    ~counted_call()
+    {
+        std::uint64_t duration = ticks() - _start;
+        std::size_t bucket = duration ? 63 - __builtin_clzll(duration) : 0;
+        add(_calls.latency[_entry][bucket < latency_buckets ? bucket : latency_buckets - 1]);
+    }
+#endif
+    counted_call(counted_call const &) = delete;
+    counted_call & operator=(counted_call const &) = delete;
+
+private:
+#if defined(API_UPDATES_CALL_LATENCY)
+    static std::uint64_t ticks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    std::uint64_t  _start;
+#endif
+    thread_calls & _calls;
+    std::size_t    _entry;
+};
+#endif
+
+}
+}
+#endif //API_UPDATES_CALL_STATS_HPP
@@ -0,0 +1,50 @@
+#ifndef API_UPDATES_COMPAT_SHIMS_HPP
+#define API_UPDATES_COMPAT_SHIMS_HPP
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include "params_conversion.hpp"
+#include "probes.hpp"
+
+// definitions of the lines of compat_entry_points.def. the header of the generation doesn't declare them any
+// more, so they are marked for export here. they are expanded in a translation unit without the functions
+// they call: the compiler can't inline the current definition into every old one, and a shim with nothing
+// left to do after the call can end in a jump to it - no frame of its own. which ones do (x86-64, Release):
+// - a FORWARD whose result comes back in registers, v_0::foo(): a jmp. the manifest marks it with tail jump and
+//   the compat_tail_calls target checks it in the disassembly of the library (CMakeLists.txt)
+// - a FORWARD that returns a class through a hidden pointer, create_internal_class_instance(int): a call.
+//   gcc doesn't tail call it, as the shim returns that pointer itself; clang does
+// - a CONVERT, v_0::init(params const &): a call with a frame, the converted params_view (24 bytes) is
+//   passed on the stack
+// call latency and call stats make every shim a call. the compat probe (probes.hpp) is an entry probe only and
+// keeps the jump
+#define API_UPDATES_FORWARD(generation, ns, return_type, name, old_parameters, arguments, probe_arg, entry, tail, symbol) \
+    inline namespace ns {                                                                                                 \
+        A_API return_type name old_parameters                                                                             \
+        {                                                                                                                 \
+            API_UPDATES_COUNT_CALL(entry);                                                                                \
+            API_UPDATES_TRACE_COMPAT(name, generation, probe_arg);                                                        \
+            return name arguments;                                                                                        \
+        }                                                                                                                 \
+    }                                                                                                                     \
+    API_UPDATES_SYMBOL_VERSION(generation, symbol)
+
+#define API_UPDATES_CONVERT(generation, ns, name, old_params, current_params, probe_arg, entry, symbol) \
+    inline namespace ns {                                                                                 \
+        A_API void name(old_params const & old)                                                           \
+        {                                                                                                 \
+            API_UPDATES_COUNT_CALL(entry);                                                                \
+            API_UPDATES_TRACE_COMPAT(name, generation, probe_arg);                                        \
+            return name(detail::convert<current_params>(old));                                            \
+        }                                                                                                 \
+    }                                                                                                     \
+    API_UPDATES_SYMBOL_VERSION(generation, symbol)
+
+// with API_UPDATES_SYMBOL_VERSIONS: the shim as the non-default version symbol@API_N only, so binaries linked
+// before keep binding to it and a new link can't pick it up. .symver has to be in the object that defines it
+#if defined(API_UPDATES_SYMBOL_VERSIONS)
+#define API_UPDATES_SYMBOL_VERSION(generation, symbol) __asm__(".symver " #symbol ", " #symbol "@API_" #generation);
+#else
+#define API_UPDATES_SYMBOL_VERSION(generation, symbol)
+#endif
+
+#endif //API_UPDATES_COMPAT_SHIMS_HPP
@@ -0,0 +1,36 @@
+#ifndef API_UPDATES_INTERNAL_CLASS_HPP
+#define API_UPDATES_INTERNAL_CLASS_HPP
+#include <api_updates/api.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace a {
+
+// case 5 - the class is only visible inside the library and can be changed freely
+class internal_class {
+public:
+    // the name comes from the resource of the object (uses-allocator construction in create_internal_class_instance)
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    internal_class(int value, std::string_view name = {}, allocator_type const & allocator = {})
+        : _value(value), _name(name, allocator) {}
+    int get_value() const { return _value.load(std::memory_order_relaxed); };
+    // the generation is incremented after the value, so whoever sees the new generation sees the new value
+    void set_value(int value)
+    {
+        _value.store(value, std::memory_order_relaxed);
+        _generation.fetch_add(1, std::memory_order_release);
+    }
+    std::atomic<std::uint32_t> const & get_generation() const { return _generation; }
+    std::string_view get_name() const { return _name; }
+private:
+    std::atomic<int>           _value;
+    std::atomic<std::uint32_t> _generation{0};
+    std::pmr::string           _name;
+};
+
+}
+#endif //API_UPDATES_INTERNAL_CLASS_HPP
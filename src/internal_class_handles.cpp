@@ -0,0 +1,225 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include "internal_class.hpp"
+#include "read_sections.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+namespace a {
+
+namespace {
+// slots live in fixed-size chunks that never move, so readers need neither a lock nor a reference count.
+// creating and destroying handles takes the table lock. a slot refers to an internal_class it keeps alive;
+// readers go through a read section (read_sections.hpp), and a destroyed object is released only after every
+// read section that could still see it has finished - like the nodes of the registry. destroyed slots wait
+// on a retired list and are reclaimed reclaim_batch at a time, so one grace period covers a whole batch and
+// short-lived handles don't pay for one each
+class handle_table {
+public:
+    internal_class_handle create(internal_class_sptr instance)
+    {
+        if (!instance)
+            throw std::invalid_argument("create_internal_class_handle: null internal_class_sptr");
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::uint32_t index;
+        if (!_free.empty()) {
+            index = _free.back();
+            _free.pop_back();
+        } else {
+            if (_size == max_chunks * chunk_size)
+                throw std::length_error("internal_class_handle table is full");
+            if (_size % chunk_size == 0) {
+                // every slot fits on either list, so destroy never allocates
+                _free.reserve(_size + chunk_size);
+                _retired.reserve(_size + chunk_size);
+                _chunks[_size / chunk_size].store(new slot[chunk_size], std::memory_order_release);
+            }
+            index = _size++;
+        }
+        slot & s = at(index);
+        // the generation was bumped when the slot was freed, so a reader still holding an old handle that
+        // sees the new object checks the generation again and sees that it changed (see read)
+        s.object.store(instance.get(), std::memory_order_release);
+        s.owner = std::move(instance);
+        return {index, s.generation.load(std::memory_order_relaxed)};
+    }
+
+    void destroy(internal_class_handle handle) noexcept
+    {
+        bool reclaim;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            slot * s = find(handle);
+            if (!s)
+                return;
+            // invalidate every copy of the handle before the slot can be reused. 0 is skipped.
+            // the slot keeps its owner: readers that found the object before may still be using it
+            std::uint32_t next = handle.generation + 1;
+            s->generation.store(next ? next : 1, std::memory_order_relaxed);
+            s->object.store(nullptr, std::memory_order_relaxed);
+            _retired.push_back(handle.index);
+            reclaim = _retired.size() >= reclaim_batch;
+        }
+        if (reclaim)
+            reclaim_retired();
+    }
+
+    // the object behind the handle outlives f, or throws std::invalid_argument for a destroyed handle.
+    // the read path: plain loads and compares and the read section of the calling thread
+    template<class Function>
+    auto read(internal_class_handle handle, Function f) const
+    {
+        detail::thread_reader * reader = detail::thread_reader::current();
+        if (!reader) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return f(get(handle));
+        }
+        struct section {
+            explicit section(detail::thread_reader & r) : reader(r) { reader.enter(); }
+            ~section() { reader.leave(); }
+            detail::thread_reader & reader;
+        } read_section(*reader);
+        return f(get(handle));
+    }
+
+    // the owning pointer, under the lock: not on the read path
+    internal_class_sptr instance(internal_class_handle handle) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        slot const * s = find(handle);
+        if (!s)
+            throw std::invalid_argument("stale internal_class_handle");
+        return s->owner;
+    }
+
+private:
+    static constexpr std::uint32_t chunk_size    = 4096;
+    static constexpr std::uint32_t max_chunks    = 1024;
+    static constexpr std::size_t   reclaim_batch = 64;
+
+    // one reclaimer at a time, so the slots retired before its grace period stay at the front of the list
+    void reclaim_retired() noexcept
+    {
+        std::lock_guard<std::mutex> reclaim_lock(_reclaim_mutex);
+        std::size_t count;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            count = _retired.size();
+        }
+        if (count < reclaim_batch)
+            return;
+        detail::synchronize_readers();
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (std::size_t i = 0; i < count; ++i) {
+            at(_retired[i]).owner.reset();
+            _free.push_back(_retired[i]);
+        }
+        _retired.erase(_retired.begin(), _retired.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    struct slot {
+        std::atomic<std::uint32_t>    generation{1};
+        std::atomic<internal_class *> object{nullptr}; // what readers use, null while the slot is free
+        internal_class_sptr           owner;           // keeps object alive until the slot is reclaimed. under the table lock
+    };
+
+    slot & at(std::uint32_t index) const
+    {
+        return _chunks[index / chunk_size].load(std::memory_order_relaxed)[index % chunk_size];
+    }
+
+    slot * find(internal_class_handle handle) const
+    {
+        if (handle.index >= max_chunks * chunk_size)
+            return nullptr;
+        slot * chunk = _chunks[handle.index / chunk_size].load(std::memory_order_acquire);
+        if (!chunk)
+            return nullptr;
+        slot & s = chunk[handle.index % chunk_size];
+        if (s.generation.load(std::memory_order_acquire) != handle.generation)
+            return nullptr;
+        return &s;
+    }
+
+    // the slot may be freed and reused by another thread at any time, so the generation is checked again
+    // after the object was loaded: an object seen with the handle's generation before and after belongs to it
+    internal_class & get(internal_class_handle handle) const
+    {
+        slot const * s = find(handle);
+        internal_class * object = s ? s->object.load(std::memory_order_acquire) : nullptr;
+        if (!object || s->generation.load(std::memory_order_relaxed) != handle.generation)
+            throw std::invalid_argument("stale internal_class_handle");
+        return *object;
+    }
+
+    std::atomic<slot *>        _chunks[max_chunks] = {};
+    mutable std::mutex         _mutex;
+    std::uint32_t              _size = 0;
+    std::vector<std::uint32_t> _free;
+    std::vector<std::uint32_t> _retired; // destroyed, waiting for a grace period
+    std::mutex                 _reclaim_mutex;
+};
+
+// never destroyed: handles may still be released from static destructors of the client
+handle_table & table()
+{
+    static handle_table & instance = *new handle_table;
+    return instance;
+}
+}
+
+inline namespace v_2
+{
+    internal_class_handle create_internal_class_handle(int value)
+    {
+        API_UPDATES_COUNT_CALL(create_internal_class_handle);
+        return table().create(create_internal_class_instance(value));
+    }
+
+    void destroy_internal_class_handle(internal_class_handle handle) noexcept
+    {
+        API_UPDATES_COUNT_CALL(destroy_internal_class_handle);
+        table().destroy(handle);
+    }
+
+    int get_value(internal_class_handle handle)
+    {
+        API_UPDATES_COUNT_CALL(get_handle_value);
+        return table().read(handle, [](internal_class const & object) { return object.get_value(); });
+    }
+}
+
+inline namespace v_3
+{
+    internal_class_handle create_internal_class_handle(internal_class_sptr instance)
+    {
+        API_UPDATES_COUNT_CALL(create_internal_class_handle_from_instance);
+        return table().create(std::move(instance));
+    }
+
+    internal_class_sptr get_instance(internal_class_handle handle)
+    {
+        API_UPDATES_COUNT_CALL(get_handle_instance);
+        return table().instance(handle);
+    }
+
+    void set_value(internal_class_handle handle, int value)
+    {
+        API_UPDATES_COUNT_CALL(set_handle_value);
+        table().read(handle, [value](internal_class & object) { object.set_value(value); });
+    }
+
+    std::size_t get_name(internal_class_handle handle, char * buffer, std::size_t capacity)
+    {
+        API_UPDATES_COUNT_CALL(get_handle_name);
+        return table().read(handle, [buffer, capacity](internal_class const & object) {
+            std::string_view name = object.get_name();
+            if (name.size() <= capacity)
+                std::copy(name.begin(), name.end(), buffer);
+            return name.size();
+        });
+    }
+}
+}
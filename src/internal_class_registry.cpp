@@ -0,0 +1,180 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include "read_sections.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+namespace a {
+
+namespace {
+using detail::thread_reader;
+
+std::uint64_t mix(std::uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    return key ^ (key >> 31);
+}
+
+// RCU-style hash table: readers walk bucket lists without a lock and never write shared memory.
+// a node is never modified once it is reachable - writers link in new nodes and delete unlinked ones
+// after a grace period. writers take the lock of one shard only
+class registry {
+public:
+    bool insert(std::uint64_t key, internal_class_sptr value)
+    {
+        if (!value)
+            throw std::invalid_argument("register_instance: null internal_class_sptr");
+        std::uint64_t hash = mix(key);
+        shard & s = shard_for(hash);
+        std::unique_lock<std::mutex> lock(s.mutex);
+        table * t = s.current.load(std::memory_order_relaxed);
+        auto *  link = &t->bucket(hash);
+        for (node * n = link->load(std::memory_order_relaxed); n; link = &n->next, n = link->load(std::memory_order_relaxed)) {
+            if (n->key == key) {
+                auto * replacement = new node{key, std::move(value), n->next.load(std::memory_order_relaxed)};
+                link->store(replacement, std::memory_order_release);
+                lock.unlock();
+                detail::synchronize_readers();
+                delete n;
+                return false;
+            }
+        }
+        auto * head = &t->bucket(hash);
+        head->store(new node{key, std::move(value), head->load(std::memory_order_relaxed)}, std::memory_order_release);
+        if (++s.size <= t->bucket_count)
+            return true;
+        // grow: the old nodes may still be read, so the new table gets copies of them
+        auto * grown = new table(t->bucket_count * 2);
+        for (std::size_t i = 0; i < t->bucket_count; ++i) {
+            for (node * n = t->buckets[i].load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed)) {
+                auto & bucket = grown->bucket(mix(n->key));
+                bucket.store(new node{n->key, n->value, bucket.load(std::memory_order_relaxed)}, std::memory_order_relaxed);
+            }
+        }
+        s.current.store(grown, std::memory_order_release);
+        lock.unlock();
+        detail::synchronize_readers();
+        delete t;
+        return true;
+    }
+
+    bool erase(std::uint64_t key)
+    {
+        std::uint64_t hash = mix(key);
+        shard & s = shard_for(hash);
+        std::unique_lock<std::mutex> lock(s.mutex);
+        auto * link = &s.current.load(std::memory_order_relaxed)->bucket(hash);
+        for (node * n = link->load(std::memory_order_relaxed); n; link = &n->next, n = link->load(std::memory_order_relaxed)) {
+            if (n->key == key) {
+                link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+                --s.size;
+                lock.unlock();
+                detail::synchronize_readers();
+                delete n;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // the read path: no lock, the only shared write is the reference count of the result
+    internal_class_sptr find(std::uint64_t key) const
+    {
+        thread_reader * reader = thread_reader::current();
+        std::uint64_t hash = mix(key);
+        shard const & s = shard_for(hash);
+        if (!reader) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            return find_in(s, hash, key);
+        }
+        reader->enter();
+        internal_class_sptr result = find_in(s, hash, key);
+        reader->leave();
+        return result;
+    }
+
+private:
+    struct node {
+        std::uint64_t       key;
+        internal_class_sptr value;
+        std::atomic<node *> next;
+    };
+
+    struct table {
+        explicit table(std::size_t count) : bucket_count(count), buckets(new std::atomic<node *>[count]())
+        {
+        }
+        ~table()
+        {
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                for (node * n = buckets[i].load(std::memory_order_relaxed); n;) {
+                    node * next = n->next.load(std::memory_order_relaxed);
+                    delete n;
+                    n = next;
+                }
+            }
+        }
+        // the low bits of the hash pick the shard, the high bits pick the bucket
+        std::atomic<node *> & bucket(std::uint64_t hash) const { return buckets[(hash >> 32) & (bucket_count - 1)]; }
+
+        std::size_t                            bucket_count; // power of 2
+        std::unique_ptr<std::atomic<node *>[]> buckets;
+    };
+
+    struct alignas(64) shard {
+        mutable std::mutex   mutex;
+        std::atomic<table *> current{new table(16)};
+        std::size_t          size = 0;
+    };
+
+    static constexpr std::size_t shard_count = 64;
+
+    shard & shard_for(std::uint64_t hash) { return _shards[hash & (shard_count - 1)]; }
+    shard const & shard_for(std::uint64_t hash) const { return _shards[hash & (shard_count - 1)]; }
+
+    static internal_class_sptr find_in(shard const & s, std::uint64_t hash, std::uint64_t key)
+    {
+        table const * t = s.current.load(std::memory_order_acquire);
+        for (node * n = t->bucket(hash).load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire)) {
+            if (n->key == key)
+                return n->value;
+        }
+        return nullptr;
+    }
+
+    shard _shards[shard_count];
+};
+
+registry & instances()
+{
+    static registry & instance = *new registry;
+    return instance;
+}
+}
+
+inline namespace v_3
+{
+    bool register_instance(std::uint64_t key, internal_class_sptr value)
+    {
+        API_UPDATES_COUNT_CALL(register_instance);
+        return instances().insert(key, std::move(value));
+    }
+
+    bool unregister_instance(std::uint64_t key)
+    {
+        API_UPDATES_COUNT_CALL(unregister_instance);
+        return instances().erase(key);
+    }
+
+    internal_class_sptr find_instance(std::uint64_t key)
+    {
+        API_UPDATES_COUNT_CALL(find_instance);
+        return instances().find(key);
+    }
+}
+}
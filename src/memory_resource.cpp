@@ -0,0 +1,66 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include "memory_resource.hpp"
+#include <new>
+namespace a {
+
+namespace {
+class heap_memory_resource final : public std::pmr::memory_resource {
+public:
+    constexpr heap_memory_resource() = default;
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, std::align_val_t(alignment));
+        return ::operator new(bytes);
+    }
+    void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator delete(ptr, bytes, std::align_val_t(alignment));
+        ::operator delete(ptr, bytes);
+    }
+    bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override { return this == &other; }
+};
+
+// a union member is not destroyed
+union never_destroyed {
+    constexpr never_destroyed() : resource() {}
+    ~never_destroyed() {}
+    heap_memory_resource resource;
+} g_heap;
+}
+
+namespace detail {
+    std::pmr::memory_resource * const        heap_resource = &g_heap.resource;
+    std::atomic<std::pmr::memory_resource *> global_resource{nullptr};
+#if defined(__GNUC__)
+    __thread __attribute__((tls_model("initial-exec"))) std::pmr::memory_resource * thread_resource = nullptr;
+#else
+    thread_local std::pmr::memory_resource * thread_resource = nullptr;
+#endif
+}
+
+inline namespace v_3
+{
+    std::pmr::memory_resource * set_memory_resource(std::pmr::memory_resource * resource) noexcept
+    {
+        API_UPDATES_COUNT_CALL(set_memory_resource);
+        return detail::global_resource.exchange(resource, std::memory_order_acq_rel);
+    }
+
+    std::pmr::memory_resource * set_thread_memory_resource(std::pmr::memory_resource * resource) noexcept
+    {
+        API_UPDATES_COUNT_CALL(set_thread_memory_resource);
+        return std::exchange(detail::thread_resource, resource);
+    }
+
+    std::pmr::memory_resource * get_memory_resource() noexcept
+    {
+        API_UPDATES_COUNT_CALL(get_memory_resource);
+        return detail::current_resource();
+    }
+}
+}
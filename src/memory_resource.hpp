@@ -0,0 +1,63 @@
+#ifndef API_UPDATES_MEMORY_RESOURCE_HPP
+#define API_UPDATES_MEMORY_RESOURCE_HPP
+#include <atomic>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace a {
+namespace detail {
+
+// set by set_memory_resource and set_thread_memory_resource (memory_resource.cpp). the thread's one is a plain
+// pointer - no constructor, no destructor - so it is a single load and can be read from thread_local destructors
+extern std::atomic<std::pmr::memory_resource *> global_resource;
+#if defined(__GNUC__)
+// __thread: constant-initialized, so the compiler doesn't check for an initializer of another translation unit
+extern __thread __attribute__((tls_model("initial-exec"))) std::pmr::memory_resource * thread_resource;
+#else
+extern thread_local std::pmr::memory_resource * thread_resource;
+#endif
+
+// the global heap like std::pmr::new_delete_resource(), but without a call into the standard library.
+// constant-initialized and never destroyed, so it works in static constructors and destructors of clients too
+extern std::pmr::memory_resource * const heap_resource;
+
+// the resource set for the calling thread, else the one set for all threads.
+// nullptr if neither is set: the library then uses its own allocation paths (the per-thread pools)
+inline std::pmr::memory_resource * current_resource() noexcept
+{
+    if (std::pmr::memory_resource * resource = thread_resource)
+        return resource;
+    return global_resource.load(std::memory_order_acquire);
+}
+
+// current_resource(), or the global heap where the library has no pool of its own
+inline std::pmr::memory_resource * resource_or_heap() noexcept
+{
+    std::pmr::memory_resource * resource = current_resource();
+    return resource ? resource : heap_resource;
+}
+
+// polymorphic_allocator::new_object and delete_object of C++20
+template<class T, class... Args>
+T * new_object(std::pmr::memory_resource * resource, Args &&... args)
+{
+    void * memory = resource->allocate(sizeof(T), alignof(T));
+    try {
+        return new(memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        resource->deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+template<class T>
+void delete_object(std::pmr::memory_resource * resource, T * object) noexcept
+{
+    object->~T();
+    resource->deallocate(object, sizeof(T), alignof(T));
+}
+
+}
+}
+#endif //API_UPDATES_MEMORY_RESOURCE_HPP
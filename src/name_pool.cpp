@@ -0,0 +1,127 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+namespace a {
+
+namespace {
+// names are copied into blocks that are never freed, so the views handed out stay valid.
+// id -> name is a lock-free read of fixed-size chunks (like the handle table); name -> id takes the lock of one shard
+class name_pool {
+public:
+    name_pool()
+    {
+        // id 0 is the empty name
+        _chunks[0].store(new entry[chunk_size](), std::memory_order_relaxed);
+        _size.store(1, std::memory_order_relaxed);
+    }
+
+    interned_name intern(std::string_view name)
+    {
+        if (name.empty())
+            return {};
+        std::size_t hash = std::hash<std::string_view>()(name);
+        shard & s = _shards[hash % shard_count];
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.ids.find(name);
+        if (it != s.ids.end())
+            return {it->second};
+        auto [id, stored] = append(name);
+        s.ids.emplace(stored, id);
+        return {id};
+    }
+
+    std::string_view get(interned_name name) const
+    {
+        if (name.id >= _size.load(std::memory_order_acquire))
+            throw std::invalid_argument("unknown interned_name");
+        entry const & e = _chunks[name.id / chunk_size].load(std::memory_order_acquire)[name.id % chunk_size];
+        return {e.data, e.size};
+    }
+
+private:
+    static constexpr std::uint32_t chunk_size  = 4096;
+    static constexpr std::uint32_t max_chunks  = 16384;
+    static constexpr std::size_t   shard_count = 64;
+    static constexpr std::size_t   block_size  = 64 * 1024;
+
+    struct entry {
+        char const * data;
+        std::size_t  size;
+    };
+
+    struct alignas(64) shard {
+        std::mutex                                        mutex;
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+    };
+
+    // copies the name into the pool and gives it the next id
+    std::pair<std::uint32_t, std::string_view> append(std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock(_append_mutex);
+        std::uint32_t id = _size.load(std::memory_order_relaxed);
+        if (id == max_chunks * chunk_size)
+            throw std::length_error("interned_name pool is full");
+        char * data;
+        if (name.size() > block_size / 4) {
+            data = new char[name.size()];
+        } else {
+            if (_block_left < name.size()) {
+                _block      = new char[block_size];
+                _block_left = block_size;
+            }
+            data = _block;
+            _block += name.size();
+            _block_left -= name.size();
+        }
+        std::memcpy(data, name.data(), name.size());
+        if (id % chunk_size == 0)
+            _chunks[id / chunk_size].store(new entry[chunk_size](), std::memory_order_release);
+        _chunks[id / chunk_size].load(std::memory_order_relaxed)[id % chunk_size] = {data, name.size()};
+        _size.store(id + 1, std::memory_order_release);
+        return {id, std::string_view(data, name.size())};
+    }
+
+    shard                      _shards[shard_count];
+    std::atomic<entry *>       _chunks[max_chunks] = {};
+    std::atomic<std::uint32_t> _size{0};
+    std::mutex                 _append_mutex;
+    char *                     _block      = nullptr;
+    std::size_t                _block_left = 0;
+};
+
+// never destroyed: interned names may be used from static destructors of the client
+name_pool & names()
+{
+    static name_pool & instance = *new name_pool;
+    return instance;
+}
+}
+
+inline namespace v_3
+{
+    interned_name intern_name(std::string_view name)
+    {
+        API_UPDATES_COUNT_CALL(intern_name);
+        return names().intern(name);
+    }
+
+    std::string_view get_name(interned_name name)
+    {
+        API_UPDATES_COUNT_CALL(get_interned_name);
+        return names().get(name);
+    }
+
+    void init(compact_params init_params)
+    {
+        API_UPDATES_COUNT_CALL(init_compact);
+        // init has no use for the id itself (api.hpp): the name is only printed
+        init(params_view{get_name(init_params.name), init_params.age});
+    }
+}
+}
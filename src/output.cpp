@@ -0,0 +1,331 @@
+#include "output.hpp"
+#include "call_stats.hpp"
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+namespace a {
+
+namespace
+{
+std::atomic<output_mode> g_mode{output_mode::sync_stdout};
+
+// bounded lock-free multi-producer queue (D. Vyukov's design), drained by a single consumer
+class output_queue {
+public:
+    static constexpr std::size_t slot_count = 1024; // power of two
+
+    output_queue()
+    {
+        for (std::size_t i = 0; i < slot_count; ++i)
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // false if the queue is full
+    bool try_push(char const * data, std::size_t size)
+    {
+        std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        slot * s;
+        for (;;) {
+            s = &_slots[pos % slot_count];
+            std::size_t sequence = s->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        std::memcpy(s->data, data, size);
+        s->size = size;
+        s->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only. calls f(data, size) for the oldest record, false if there is none
+    template<class F>
+    bool try_pop(F && f)
+    {
+        slot & s = _slots[_dequeue_pos % slot_count];
+        if (s.sequence.load(std::memory_order_acquire) != _dequeue_pos + 1)
+            return false;
+        f(s.data, s.size);
+        s.sequence.store(_dequeue_pos + slot_count, std::memory_order_release);
+        ++_dequeue_pos;
+        return true;
+    }
+
+    // number of records pushed or being pushed so far
+    std::size_t enqueued() const { return _enqueue_pos.load(std::memory_order_acquire); }
+
+private:
+    struct slot {
+        std::atomic<std::size_t> sequence;
+        std::size_t              size;
+        char                     data[detail::output_line::capacity];
+    };
+
+    slot                                  _slots[slot_count];
+    alignas(64) std::atomic<std::size_t>  _enqueue_pos{0};
+    alignas(64) std::size_t               _dequeue_pos = 0;
+};
+
+void write_to_stdout(void *, char const * data, std::size_t size)
+{
+    std::fwrite(data, 1, size, stdout);
+}
+
+// true inside a sink: the thread that delivers records holds the sink lock
+thread_local bool in_sink = false;
+
+// the sink of async mode. apart from async_output: setting it doesn't start the output thread.
+// records are delivered with the mutex held, so once set_sink returned the old sink is not called any more.
+// never destroyed, like async_output
+class sink_holder {
+public:
+    static sink_holder & instance()
+    {
+        static sink_holder & holder = *new sink_holder;
+        return holder;
+    }
+
+    void set_sink(output_sink sink, void * context)
+    {
+        // called by a sink: this thread already holds the mutex, the new sink gets the next record
+        std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+        if (!in_sink)
+            lock.lock();
+        _sink    = sink ? sink : &write_to_stdout;
+        _context = sink ? context : nullptr;
+    }
+
+    // f(sink, context) with the sink locked. a sink that writes a record has the lock already
+    template<class F>
+    void deliver(F && f)
+    {
+        if (in_sink) {
+            f(_sink, _context);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        struct delivering {
+            delivering() { in_sink = true; }
+            ~delivering() { in_sink = false; }
+        } scope;
+        f(_sink, _context);
+    }
+
+private:
+    std::mutex  _mutex;
+    output_sink _sink    = &write_to_stdout;
+    void *      _context = nullptr;
+};
+
+// the queue and the thread that drains it. created on first use of async mode and never destroyed,
+// so records written from static destructors don't touch a dead object
+class async_output {
+public:
+    static async_output & instance()
+    {
+        static async_output & output = *[] {
+            async_output * created_output = new async_output;
+            created.store(created_output, std::memory_order_release);
+            return created_output;
+        }();
+        // joins the thread after delivering what is left in the queue. the mode stays: later records go to
+        // the sink on the thread that writes them
+        static struct stopper {
+            ~stopper() { output.stop(); }
+        } stop_at_exit;
+        return output;
+    }
+
+    // null until async mode was first selected: querying the output or setting a sink must not start its thread
+    static async_output * existing() { return created.load(std::memory_order_acquire); }
+
+    void push(char const * data, std::size_t size)
+    {
+        // the consumer exits only with no producer between this and the end of try_push, and a producer
+        // that comes later sees _stop (both sides are seq_cst), so no pushed record is left in the queue
+        _producers.fetch_add(1, std::memory_order_seq_cst);
+        if (_stop.load(std::memory_order_seq_cst)) {
+            _producers.fetch_sub(1, std::memory_order_relaxed);
+            // the thread is stopping (exit): deliver on this thread, after what is still in the queue.
+            // a record written by a sink can't drain the queue, its sink is in the middle of a pop
+            bool nested = in_sink;
+            sink_holder::instance().deliver([&](output_sink & sink, void *& context) {
+                if (!nested)
+                    drain(sink, context);
+                sink(context, data, size);
+            });
+            return;
+        }
+        bool pushed = _queue.try_push(data, size);
+        _producers.fetch_sub(1, std::memory_order_seq_cst);
+        if (!pushed) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // only the producer that sees the consumer asleep pays for the notification. the fence pairs with the
+        // one in run(): either the consumer sees this record before it sleeps, or this producer sees it idle
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_idle.load(std::memory_order_relaxed) && _consumer_idle.exchange(false)) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _wake.notify_one();
+        }
+    }
+
+    void flush()
+    {
+        // called by a sink: the records can't be waited for on the thread that delivers them
+        if (in_sink)
+            return;
+        std::size_t target = _queue.enqueued();
+        std::unique_lock<std::mutex> lock(_mutex);
+        // after the thread exited every record is delivered by the thread that writes it
+        _drained.wait(lock, [&] { return _delivered.load(std::memory_order_acquire) >= target || _exited; });
+    }
+
+    std::uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<async_output *> created{nullptr};
+
+    async_output() : _thread([this] { run(); }) {}
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop.store(true, std::memory_order_release);
+            _wake.notify_one();
+        }
+        _thread.join();
+    }
+
+    // with the sink locked: the lock makes whoever holds it the single consumer of the queue
+    void drain(output_sink & sink, void *& context)
+    {
+        // reads sink on every record: the sink may replace itself
+        while (_queue.try_pop([&](char const * data, std::size_t size) { sink(context, data, size); }))
+            _delivered.fetch_add(1, std::memory_order_release);
+    }
+
+    void run()
+    {
+        for (;;) {
+            sink_holder::instance().deliver([this](output_sink & sink, void *& context) { drain(sink, context); });
+            std::unique_lock<std::mutex> lock(_mutex);
+            _drained.notify_all();
+            if (_stop.load(std::memory_order_seq_cst) && _producers.load(std::memory_order_seq_cst) == 0
+                && _delivered.load(std::memory_order_relaxed) == _queue.enqueued()) {
+                _exited = true;
+                _drained.notify_all();
+                return;
+            }
+            // a record pushed before the flag was set came from a producer that saw the consumer awake:
+            // look at the queue once more before sleeping (the fence pairs with the one in push)
+            _consumer_idle.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_delivered.load(std::memory_order_relaxed) == _queue.enqueued() && !_stop.load(std::memory_order_relaxed))
+                _wake.wait(lock, [this] {
+                    return !_consumer_idle.load(std::memory_order_relaxed) || _stop.load(std::memory_order_relaxed);
+                });
+            _consumer_idle.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    output_queue               _queue;
+    std::atomic<std::size_t>   _delivered{0};
+    std::atomic<std::uint64_t> _dropped{0};
+    std::atomic<std::uint32_t> _producers{0}; // between the _stop check and the end of try_push
+    std::atomic<bool>          _consumer_idle{false};
+    std::mutex                 _mutex;
+    std::condition_variable    _wake;
+    std::condition_variable    _drained;
+    std::atomic<bool>          _stop{false};
+    bool                       _exited = false;
+    std::thread                _thread;
+};
+}
+
+namespace detail
+{
+    output_line::output_line() : _mode(g_mode.load(std::memory_order_relaxed)) {}
+
+    output_line::~output_line()
+    {
+        if (_mode != output_mode::async)
+            return;
+        if (_truncated)
+            std::memcpy(_buffer + capacity - 4, "...\n", 4);
+        async_output::instance().push(_buffer, _size);
+    }
+
+    output_line & output_line::operator<<(std::string_view text)
+    {
+        if (_mode == output_mode::sync_stdout) {
+            std::cout << text;
+        } else if (_mode == output_mode::async) {
+            std::size_t count = std::min(text.size(), capacity - _size);
+            std::memcpy(_buffer + _size, text.data(), count);
+            _size += count;
+            _truncated = _truncated || count != text.size();
+        }
+        return *this;
+    }
+
+    output_line & output_line::operator<<(int value)
+    {
+        if (_mode == output_mode::sync_stdout) {
+            std::cout << value;
+        } else if (_mode == output_mode::async) {
+            char digits[16];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            *this << std::string_view(digits, result.ptr - digits);
+        }
+        return *this;
+    }
+}
+
+inline namespace v_2
+{
+    void set_output_mode(output_mode mode)
+    {
+        API_UPDATES_COUNT_CALL(set_output_mode);
+        if (mode == output_mode::async)
+            async_output::instance(); // start the output thread before the first record
+        g_mode.store(mode, std::memory_order_relaxed);
+    }
+
+    void set_output_sink(output_sink sink, void * context)
+    {
+        API_UPDATES_COUNT_CALL(set_output_sink);
+        sink_holder::instance().set_sink(sink, context);
+    }
+
+    void flush_output()
+    {
+        API_UPDATES_COUNT_CALL(flush_output);
+        if (g_mode.load(std::memory_order_relaxed) == output_mode::sync_stdout)
+            std::cout.flush();
+        else if (async_output * output = async_output::existing())
+            output->flush();
+    }
+
+    std::uint64_t dropped_output_records()
+    {
+        API_UPDATES_COUNT_CALL(dropped_output_records);
+        async_output * output = async_output::existing();
+        return output ? output->dropped() : 0;
+    }
+}
+}
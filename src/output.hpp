@@ -0,0 +1,35 @@
+#ifndef API_UPDATES_OUTPUT_HPP
+#define API_UPDATES_OUTPUT_HPP
+#include <api_updates/api.hpp>
+#include <cstddef>
+#include <string_view>
+
+namespace a {
+namespace detail {
+
+// one output record. the pieces go straight to std::cout in sync_stdout mode (exactly what the library
+// used to do); in async mode they are formatted without locale into a fixed buffer on the caller's stack
+// and queued when the line is destroyed. usage: output_line() << "text" << 42 << "\n";
+class output_line {
+public:
+    // longer records are cut and end with "...\n"
+    static constexpr std::size_t capacity = 240;
+
+    output_line();
+    ~output_line();
+    output_line(output_line const &) = delete;
+    output_line & operator=(output_line const &) = delete;
+
+    output_line & operator<<(std::string_view text);
+    output_line & operator<<(int value);
+
+private:
+    output_mode _mode;
+    bool        _truncated = false;
+    std::size_t _size = 0;
+    char        _buffer[capacity];
+};
+
+}
+}
+#endif //API_UPDATES_OUTPUT_HPP
@@ -0,0 +1,116 @@
+#ifndef API_UPDATES_PARAMS_CONVERSION_HPP
+#define API_UPDATES_PARAMS_CONVERSION_HPP
+#include <type_traits>
+
+namespace a {
+namespace detail {
+
+// case 2 - declarative conversion of old params into the current ones.
+// each generation declares only how its fields map onto the next generation:
+//
+//     template<> struct next_generation<v_0::params> {
+//         using type   = v_1::params_view;
+//         using fields = field_list<field_map<&v_0::params::name, &v_1::params_view::name>>;
+//     };
+//
+// convert<Current>(old) follows every field through all later generations at compile time and assigns
+// it straight into the current struct: no temporary struct per generation, the cost doesn't depend on
+// how old the caller is. a field that a later generation doesn't map any more is dropped. a field the
+// caller's generation doesn't have gets the default of the generation that introduced it, a field of
+// Current that isn't mapped from any generation keeps its default
+template<auto From, auto To>
+struct field_map {};
+
+template<class... Fields>
+struct field_list {};
+
+template<class Params>
+struct next_generation; // no specialization: Params is the newest generation
+
+namespace conversion {
+template<class Params, class = void>
+struct has_next : std::false_type {};
+template<class Params>
+struct has_next<Params, std::void_t<typename next_generation<Params>::type>> : std::true_type {};
+
+template<auto Member>
+using member_tag = std::integral_constant<decltype(Member), Member>;
+
+struct dropped {};
+
+// the field of the next generation that Member maps to: dropped if there is none
+template<auto Member, class Fields>
+struct map_once;
+template<auto Member>
+struct map_once<Member, field_list<>> {
+    using type = dropped;
+};
+template<auto Member, auto From, auto To, class... Rest>
+struct map_once<Member, field_list<field_map<From, To>, Rest...>> {
+    using type = std::conditional_t<std::is_same_v<member_tag<Member>, member_tag<From>>,
+                                    member_tag<To>,
+                                    typename map_once<Member, field_list<Rest...>>::type>;
+};
+
+// follows Member of Params up to Target
+template<class Params, class Target, class Member>
+struct resolve {
+    using type = dropped;
+};
+template<class Params, class Target, auto Member>
+struct resolve<Params, Target, member_tag<Member>> {
+    using next = next_generation<Params>;
+    using type = typename resolve<typename next::type, Target,
+                                  typename map_once<Member, typename next::fields>::type>::type;
+};
+template<class Target, auto Member>
+struct resolve<Target, Target, member_tag<Member>> {
+    using type = member_tag<Member>;
+};
+
+// From of the source with the field of the target it ends up in
+template<auto From, class To>
+struct resolved_field {};
+
+template<class Target, class Source, auto From, class To>
+void assign(Target & target, Source const & source, resolved_field<From, To>)
+{
+    if constexpr (!std::is_same_v<To, dropped>)
+        target.*(To::value) = source.*From;
+}
+
+template<class Target, class Source, auto... From, auto... To>
+void assign_all(Target & target, Source const & source, field_list<field_map<From, To>...>)
+{
+    (assign(target, source,
+            resolved_field<From, typename resolve<typename next_generation<Source>::type, Target,
+                                                  member_tag<To>>::type>{}),
+     ...);
+}
+
+// the defaults of the generations between the source and Target, the newer ones first so that the
+// oldest generation with a field wins. static: a view field may point into its default
+template<class Target, class Params>
+void assign_defaults(Target & target)
+{
+    if constexpr (!std::is_same_v<Params, Target>) {
+        assign_defaults<Target, typename next_generation<Params>::type>(target);
+        static Params const defaults{};
+        assign_all(target, defaults, typename next_generation<Params>::fields{});
+    }
+}
+}
+
+template<class Target, class Source>
+Target convert(Source const & source)
+{
+    static_assert(conversion::has_next<Source>::value, "Source is the newest generation, there is nothing to convert");
+    Target target{};
+    conversion::assign_defaults<Target, typename next_generation<Source>::type>(target);
+    conversion::assign_all(target, source, typename next_generation<Source>::fields{});
+    return target;
+}
+
+}
+}
+#endif //API_UPDATES_PARAMS_CONVERSION_HPP
@@ -0,0 +1,252 @@
+#include <api_updates/api.hpp>
+#include "call_stats.hpp"
+#include "batch.hpp"
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define API_UPDATES_HAS_MMAP 1
+#else
+#include <cstdio>
+#include <vector>
+#endif
+namespace a {
+
+namespace {
+// the offsets of the fields in the fixed parts. new fields are only appended
+enum : std::size_t {
+    magic_offset       = 0,
+    fixed_size_offset  = 4,
+    name_offset_offset = 8,
+    name_size_offset   = 12,
+    age_offset         = 16,
+    fixed_size_v_0     = 16, // magic, fixed_size and name
+    fixed_size_v_1     = 20  // + age
+};
+
+enum : std::size_t {
+    count_offset           = 8,
+    mapping_fixed_size_v_0 = 16, // magic, fixed_size and count
+    table_entry_size       = 8
+};
+
+// byte by byte: the buffer may be unaligned and the host may be big-endian
+std::uint32_t load(std::byte const * data)
+{
+    return std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8 | std::uint32_t(data[2]) << 16 | std::uint32_t(data[3]) << 24;
+}
+
+std::uint64_t load64(std::byte const * data) { return load(data) | std::uint64_t(load(data + 4)) << 32; }
+
+void store(std::byte * data, std::uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        data[i] = std::byte(value >> (8 * i));
+}
+
+void store64(std::byte * data, std::uint64_t value)
+{
+    store(data, static_cast<std::uint32_t>(value));
+    store(data + 4, static_cast<std::uint32_t>(value >> 32));
+}
+
+params_view view_of(params const & init_params) { return {init_params.name, init_params.age}; }
+
+// 0 if the name doesn't fit the 32-bit name size (the offset of the name is fixed_size_v_1)
+std::size_t encoded_size(params_view init_params)
+{
+    if (init_params.name.size() > std::numeric_limits<std::uint32_t>::max())
+        return 0;
+    return fixed_size_v_1 + init_params.name.size();
+}
+
+// out has room for encoded_size(init_params) bytes, which is not 0
+void encode(params_view init_params, std::byte * out)
+{
+    store(out + magic_offset, params_wire_magic);
+    store(out + fixed_size_offset, fixed_size_v_1);
+    store(out + name_offset_offset, fixed_size_v_1);
+    store(out + name_size_offset, static_cast<std::uint32_t>(init_params.name.size()));
+    store(out + age_offset, static_cast<std::uint32_t>(init_params.age));
+    init_params.name.copy(reinterpret_cast<char *>(out + fixed_size_v_1), init_params.name.size());
+}
+
+bool decode(std::byte const * data, std::size_t size, params_view & out)
+{
+    if (size < fixed_size_v_0 || load(data + magic_offset) != params_wire_magic)
+        return false;
+    std::uint32_t fixed_size = load(data + fixed_size_offset);
+    // 64-bit sums: the offsets come from outside and must not wrap around
+    std::uint64_t name_offset = load(data + name_offset_offset);
+    std::uint64_t name_size   = load(data + name_size_offset);
+    if (fixed_size < fixed_size_v_0 || fixed_size > size || name_offset + name_size > size)
+        return false;
+    out.name = std::string_view(reinterpret_cast<char const *>(data + name_offset), name_size);
+    out.age  = fixed_size >= fixed_size_v_1 ? static_cast<int>(load(data + age_offset)) : 0;
+    return true;
+}
+
+// only the header is checked up front. a record is checked by the thread that initializes it,
+// so nothing but the header and the offset table is read before the batch starts
+class mapping {
+public:
+    mapping(std::byte const * data, std::size_t size) : _data(data), _size(size)
+    {
+        if (size < mapping_fixed_size_v_0 || load(data + magic_offset) != params_mapping_magic)
+            throw std::invalid_argument("not a params mapping");
+        std::uint64_t fixed_size = load(data + fixed_size_offset);
+        _count = load64(data + count_offset);
+        if (fixed_size < mapping_fixed_size_v_0 || fixed_size > size
+            || _count >= (size - fixed_size) / table_entry_size)
+            throw std::invalid_argument("not a params mapping");
+        _table = data + fixed_size;
+    }
+
+    std::size_t count() const { return static_cast<std::size_t>(_count); }
+
+    void init_record(std::size_t index) const
+    {
+        std::uint64_t begin = load64(_table + index * table_entry_size);
+        std::uint64_t end   = load64(_table + (index + 1) * table_entry_size);
+        params_view record;
+        if (begin > end || end > _size || !decode(_data + begin, end - begin, record))
+            throw std::invalid_argument("params mapping: record " + std::to_string(index) + " is not a params buffer");
+        init(record);
+    }
+
+private:
+    std::byte const * _data;
+    std::size_t       _size;
+    std::uint64_t     _count;
+    std::byte const * _table;
+};
+
+void init_all(mapping const & records, std::size_t max_threads)
+{
+    detail::run_batch([&records](std::size_t index) { records.init_record(index); }, records.count(), max_threads);
+}
+
+[[noreturn]] void throw_file_error(char const * what, char const * path)
+{
+    throw std::system_error(errno, std::generic_category(), std::string("init_from_file: ") + what + " " + path);
+}
+}
+
+inline namespace v_3
+{
+    std::size_t write_params(params_view init_params, std::byte * out, std::size_t capacity) noexcept
+    {
+        API_UPDATES_COUNT_CALL(write_params);
+        std::size_t size = encoded_size(init_params);
+        if (size && size <= capacity)
+            encode(init_params, out);
+        return size;
+    }
+
+    bool read_params(std::byte const * data, std::size_t size, params_view & out) noexcept
+    {
+        API_UPDATES_COUNT_CALL(read_params);
+        return decode(data, size, out);
+    }
+
+    void init_from_buffer(std::byte const * data, std::size_t size)
+    {
+        API_UPDATES_COUNT_CALL(init_from_buffer);
+        params_view init_params;
+        if (!decode(data, size, init_params))
+            throw std::invalid_argument("not a params buffer");
+        init(init_params);
+    }
+
+    std::size_t write_params_mapping(params const * first, std::size_t count, std::byte * out, std::size_t capacity) noexcept
+    {
+        API_UPDATES_COUNT_CALL(write_params_mapping);
+        std::size_t table_size = (count + 1) * table_entry_size;
+        std::size_t size = mapping_fixed_size_v_0 + table_size;
+        // the offsets in the table are 64 bits, only the name size of a record is limited
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t record_size = encoded_size(view_of(first[i]));
+            if (!record_size)
+                return 0;
+            size += record_size;
+        }
+        if (size > capacity)
+            return size;
+        store(out + magic_offset, params_mapping_magic);
+        store(out + fixed_size_offset, mapping_fixed_size_v_0);
+        store64(out + count_offset, count);
+        std::byte * table = out + mapping_fixed_size_v_0;
+        std::size_t offset = mapping_fixed_size_v_0 + table_size;
+        for (std::size_t i = 0; i < count; ++i) {
+            store64(table + i * table_entry_size, offset);
+            params_view record = view_of(first[i]);
+            encode(record, out + offset);
+            offset += encoded_size(record);
+        }
+        store64(table + count * table_entry_size, offset);
+        return size;
+    }
+
+    void init_from_mapping(void const * data, std::size_t size, std::size_t max_threads)
+    {
+        API_UPDATES_COUNT_CALL(init_from_mapping);
+        init_all(mapping(static_cast<std::byte const *>(data), size), max_threads);
+    }
+
+    void init_from_file(char const * path, std::size_t max_threads)
+    {
+        API_UPDATES_COUNT_CALL(init_from_file);
+#if defined(API_UPDATES_HAS_MMAP)
+        int file = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+            throw_file_error("can't open", path);
+        struct stat status;
+        if (::fstat(file, &status) != 0) {
+            int error = errno;
+            ::close(file);
+            errno = error;
+            throw_file_error("can't stat", path);
+        }
+        auto size = static_cast<std::size_t>(status.st_size);
+        // an empty file can't be mapped, and isn't a params mapping either
+        void * data = size ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0) : nullptr;
+        int error = errno;
+        ::close(file);
+        if (data == MAP_FAILED) {
+            errno = error;
+            throw_file_error("can't map", path);
+        }
+        struct unmap {
+            ~unmap()
+            {
+                if (data)
+                    ::munmap(data, size);
+            }
+            void *      data;
+            std::size_t size;
+        } unmap_at_return{data, size};
+        init_all(mapping(static_cast<std::byte const *>(data), size), max_threads);
+#else
+        // no mmap: the file is read into memory at once
+        std::FILE * file = std::fopen(path, "rb");
+        if (!file)
+            throw_file_error("can't open", path);
+        std::vector<std::byte> contents;
+        std::byte chunk[65536];
+        for (std::size_t read; (read = std::fread(chunk, 1, sizeof(chunk), file)) != 0;)
+            contents.insert(contents.end(), chunk, chunk + read);
+        bool failed = std::ferror(file) != 0;
+        std::fclose(file);
+        if (failed)
+            throw_file_error("can't read", path);
+        init_all(mapping(contents.data(), contents.size()), max_threads);
+#endif
+    }
+}
+}
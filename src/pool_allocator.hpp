@@ -0,0 +1,106 @@
+#ifndef API_UPDATES_POOL_ALLOCATOR_HPP
+#define API_UPDATES_POOL_ALLOCATOR_HPP
+#include <cstddef>
+#include <new>
+
+namespace a {
+namespace detail {
+
+// per-thread cache of free blocks of one size. a block freed on another thread
+// goes to that thread's cache, so there is no synchronization at all
+template<std::size_t Size>
+class block_cache {
+public:
+    static constexpr std::size_t max_cached_blocks = 1024;
+
+    static void * allocate()
+    {
+        if (!_destroyed) {
+            auto & cache = instance();
+            if (cache._head) {
+                node * block = cache._head;
+                cache._head = block->next;
+                --cache._size;
+                return block;
+            }
+        }
+        return ::operator new(block_size);
+    }
+
+    static void deallocate(void * ptr) noexcept
+    {
+        if (!_destroyed) {
+            auto & cache = instance();
+            if (cache._size < max_cached_blocks) {
+                cache._head = new(ptr) node{cache._head};
+                ++cache._size;
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+private:
+    struct node { node * next; };
+    static constexpr std::size_t block_size = Size < sizeof(node) ? sizeof(node) : Size;
+
+    block_cache() = default;
+    ~block_cache()
+    {
+        _destroyed = true;
+        while (_head) {
+            node * block = _head;
+            _head = block->next;
+            ::operator delete(block);
+        }
+    }
+
+    static block_cache & instance()
+    {
+        thread_local block_cache cache;
+        return cache;
+    }
+
+    node *      _head = nullptr;
+    std::size_t _size = 0;
+    // trivially destructible, so it can still be checked while other thread_locals are destroyed
+    static thread_local bool _destroyed;
+};
+
+template<std::size_t Size>
+thread_local bool block_cache<Size>::_destroyed = false;
+
+// stateless allocator for std::allocate_shared: the object and its control block come from the cache
+template<class T>
+class pool_allocator {
+public:
+    using value_type = T;
+
+    pool_allocator() = default;
+    template<class U>
+    pool_allocator(pool_allocator<U> const &) noexcept {}
+
+    T * allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        if (n != 1)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(block_cache<sizeof(T)>::allocate());
+    }
+
+    void deallocate(T * ptr, std::size_t n) noexcept
+    {
+        if (n != 1)
+            return ::operator delete(ptr);
+        block_cache<sizeof(T)>::deallocate(ptr);
+    }
+
+    template<class U>
+    bool operator==(pool_allocator<U> const &) const noexcept { return true; }
+    template<class U>
+    bool operator!=(pool_allocator<U> const &) const noexcept { return false; }
+};
+
+}
+}
+#endif //API_UPDATES_POOL_ALLOCATOR_HPP
@@ -0,0 +1,40 @@
+#ifndef API_UPDATES_PROBES_HPP
+#define API_UPDATES_PROBES_HPP
+
+// USDT probes (provider api_updates) at entry and exit of the main entry points, e.g.
+//     bpftrace -e 'usdt:./libapi_updates.so:api_updates:init_entry { @[arg0] = count(); }'
+// a probe is a nop until a tracer attaches to it. the first argument of every probe is the generation of
+// the definition: the N of the version namespace v_N it is defined in. the compatibility definitions old
+// binaries call (compat_entry_points.def) have an entry probe of their own, name_compat_entry, before the
+// probes of the current definition they call: name_entry counts every call once, the time from
+// name_compat_entry to name_entry is the cost of the compatibility step and name_exit of the current
+// definition ends both, e.g. v_0::init (init_compat_entry(0, ...)) before init(params_view) (init_entry(1, ...)).
+// a shim has no exit probe: a probe at entry is a nop that leaves the shim free to end in a jump
+// without <sys/sdt.h> (systemtap-sdt-dev) or with -DAPI_UPDATES_NO_PROBES the probes compile to nothing;
+// with -DAPI_UPDATES_REQUIRE_PROBES a missing <sys/sdt.h> is an error
+#if !defined(API_UPDATES_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define API_UPDATES_HAS_PROBES 1
+#endif
+#endif
+#if defined(API_UPDATES_REQUIRE_PROBES) && !defined(API_UPDATES_HAS_PROBES)
+#error "API_UPDATES_REQUIRE_PROBES: <sys/sdt.h> not found"
+#endif
+
+#if defined(API_UPDATES_HAS_PROBES)
+// API_UPDATES_TRACE(name, generation, arg): name_entry(generation, arg) now, name_exit(generation) when the scope ends.
+// API_UPDATES_TRACE_COMPAT(name, generation, arg): name_compat_entry(generation, arg) only. generation must be a literal
+#define API_UPDATES_TRACE(name, generation, arg) API_UPDATES_TRACE_PROBES(name, generation, arg)
+#define API_UPDATES_TRACE_COMPAT(name, generation, arg) STAP_PROBE2(api_updates, name##_compat_entry, generation, arg)
+#define API_UPDATES_TRACE_PROBES(probe, generation, arg)                                           \
+    STAP_PROBE2(api_updates, probe##_entry, generation, arg);                                      \
+    struct api_updates_trace_##probe {                                                             \
+        ~api_updates_trace_##probe() { STAP_PROBE1(api_updates, probe##_exit, generation); }      \
+    } api_updates_trace_exit
+#else
+#define API_UPDATES_TRACE(name, generation, arg) static_cast<void>(0)
+#define API_UPDATES_TRACE_COMPAT(name, generation, arg) static_cast<void>(0)
+#endif
+
+#endif //API_UPDATES_PROBES_HPP
@@ -0,0 +1,89 @@
+#include "read_sections.hpp"
+#include <thread>
+#if defined(__linux__) && __has_include(<linux/membarrier.h>)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define API_UPDATES_HAS_MEMBARRIER 1
+#endif
+namespace a {
+namespace detail {
+
+namespace {
+class reader_slots {
+public:
+    // with membarrier the writer forces the memory barrier on every running thread,
+    // so the read section itself gets away with a compiler barrier
+    reader_slots()
+    {
+#if defined(API_UPDATES_HAS_MEMBARRIER)
+        asymmetric = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#endif
+    }
+
+    reader_slot * acquire()
+    {
+        for (reader_slot * s = _head.load(std::memory_order_acquire); s; s = s->next) {
+            bool expected = false;
+            if (!s->in_use.load(std::memory_order_relaxed)
+                && s->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return s;
+        }
+        auto * s = new reader_slot;
+        s->next  = _head.load(std::memory_order_relaxed);
+        while (!_head.compare_exchange_weak(s->next, s, std::memory_order_release, std::memory_order_relaxed)) {}
+        return s;
+    }
+
+    void synchronize() const
+    {
+        barrier();
+        for (reader_slot * s = _head.load(std::memory_order_acquire); s; s = s->next) {
+            std::uint64_t sequence = s->sequence.load(std::memory_order_acquire);
+            if (sequence % 2 == 0)
+                continue;
+            while (s->sequence.load(std::memory_order_acquire) == sequence)
+                std::this_thread::yield();
+        }
+    }
+
+    bool asymmetric = false;
+
+private:
+    void barrier() const
+    {
+#if defined(API_UPDATES_HAS_MEMBARRIER)
+        if (asymmetric && syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) == 0)
+            return;
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    std::atomic<reader_slot *> _head{nullptr};
+};
+
+// never destroyed, like the tables that use it: lookups may come from static destructors of the client
+reader_slots & slots()
+{
+    static reader_slots & instance = *new reader_slots;
+    return instance;
+}
+}
+
+void synchronize_readers()
+{
+    slots().synchronize();
+}
+
+thread_local bool thread_reader::_destroyed = false;
+
+thread_reader::thread_reader() : _slot(slots().acquire()), _asymmetric(slots().asymmetric) {}
+
+thread_reader::~thread_reader()
+{
+    _destroyed = true;
+    _slot->in_use.store(false, std::memory_order_release);
+}
+
+}
+}
@@ -0,0 +1,59 @@
+#ifndef API_UPDATES_READ_SECTIONS_HPP
+#define API_UPDATES_READ_SECTIONS_HPP
+#include <atomic>
+#include <cstdint>
+
+namespace a {
+namespace detail {
+
+// RCU-style read sections for the library's lock-free tables (the registry, the handle table): a reader
+// enters and leaves a section without writing any shared memory, and a writer that unlinked something calls
+// synchronize_readers() before it deletes it
+
+// every thread that reads owns one slot. its counter is odd while the thread is inside a read section.
+// slots are never freed - a slot released by an exiting thread is reused by the next one
+struct alignas(64) reader_slot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<bool>          in_use{true};
+    reader_slot *              next = nullptr;
+};
+
+// returns once every read section that was running on entry has finished.
+// the caller has already unlinked what it is going to delete
+void synchronize_readers();
+
+class thread_reader {
+public:
+    thread_reader();
+    ~thread_reader();
+
+    // only this thread writes the counter, so no read-modify-write is needed
+    void enter()
+    {
+        _slot->sequence.store(_slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (_asymmetric)
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        else
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    void leave() { _slot->sequence.store(_slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // nullptr once the thread_local was destroyed on this thread: the caller falls back to its lock
+    static thread_reader * current()
+    {
+        if (_destroyed)
+            return nullptr;
+        thread_local thread_reader reader;
+        return &reader;
+    }
+
+private:
+    reader_slot * _slot;
+    bool          _asymmetric;
+    // trivially destructible, so it can still be checked while other thread_locals are destroyed
+    static thread_local bool _destroyed;
+};
+
+}
+}
+#endif //API_UPDATES_READ_SECTIONS_HPP
@@ -0,0 +1,61 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+namespace a {
+namespace detail {
+
+thread_pool & thread_pool::instance()
+{
+    static thread_pool & pool = *new thread_pool;
+    static struct stopper {
+        ~stopper() { pool.stop(); }
+    } stop_at_exit;
+    return pool;
+}
+
+// initialization is mostly waiting, so there are a few workers even on a single core
+thread_pool::thread_pool()
+{
+    std::size_t count = std::max(4u, std::thread::hardware_concurrency());
+    _workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        _workers.emplace_back([this] { run(); });
+}
+
+void thread_pool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _wake.notify_one();
+}
+
+void thread_pool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (auto & worker : _workers)
+        worker.join();
+}
+
+void thread_pool::run()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this] { return _stop || !_tasks.empty(); });
+            if (_tasks.empty())
+                return;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}
+}
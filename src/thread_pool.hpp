@@ -0,0 +1,38 @@
+#ifndef API_UPDATES_THREAD_POOL_HPP
+#define API_UPDATES_THREAD_POOL_HPP
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace a {
+namespace detail {
+
+// the library's worker threads. started on first use, never destroyed: at exit the queued tasks
+// are run and the workers are joined
+class thread_pool {
+public:
+    static thread_pool & instance();
+
+    // tasks must not throw
+    void submit(std::function<void()> task);
+
+    std::size_t size() const { return _workers.size(); }
+
+private:
+    thread_pool();
+    void stop();
+    void run();
+
+    std::mutex                        _mutex;
+    std::condition_variable           _wake;
+    std::deque<std::function<void()>> _tasks;
+    bool                              _stop = false;
+    std::vector<std::thread>          _workers;
+};
+
+}
+}
+#endif //API_UPDATES_THREAD_POOL_HPP
@@ -1,18 +1,208 @@
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
 #include <api_updates/api.hpp>
 
+// output sink for async mode
+void print_with_prefix(void * prefix, char const * data, std::size_t size)
+{
+    std::cout << static_cast<char const *>(prefix) << std::string_view(data, size);
+}
+
+// a sink that takes one record and hands the next ones to print_with_prefix. calls back into the library
+void first_record_sink(void *, char const * data, std::size_t size)
+{
+    std::cout << "[first record] " << std::string_view(data, size);
+    a::flush_output();
+    a::set_output_sink(&print_with_prefix, const_cast<char *>("[async sink] "));
+}
+
+// a record written after the output thread stopped at exit still goes to the sink
+struct write_at_exit {
+    ~write_at_exit() { a::foo(4); }
+} exit_record;
+
+// memory resource that counts what the library allocates from it
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override { return this == &other; }
+};
+
 int main() {
     a::params params;
     params.name = "John";
     a::init(params);
+    // init from a name that is not owned by a std::string
+    a::init(a::params_view{"Jane", 30});
+    // init pinned to an API generation at compile time
+    a::init<0>(a::params_t<0>{"Old"});
+    a::init<1>(a::params_view_t<1>{"New", 40});
+    // init on a library thread
+    a::init_async(a::params_view{"Async", 50}).get();
+    // init with an interned name
+    a::compact_params compact{a::intern_name("Compact"), 70};
+    a::init(compact);
+    std::cout << "intern_name(\"Compact\") == compact.name: " << (a::intern_name("Compact") == compact.name) << "\n";
+    // init from a flat buffer: the name is read in place
+    std::vector<std::byte> wire(a::write_params(a::params_view{"Wire", 80}, nullptr, 0));
+    a::write_params(a::params_view{"Wire", 80}, wire.data(), wire.size());
+    a::init_from_buffer(wire.data(), wire.size());
+    // a generation 0 writer: fixed_size 16, no age
+    std::byte old_wire[20] = {};
+    old_wire[0] = std::byte('A'), old_wire[1] = std::byte('P'), old_wire[2] = std::byte('R'), old_wire[3] = std::byte('M');
+    old_wire[4] = old_wire[8] = std::byte(16);
+    old_wire[12] = std::byte(4);
+    old_wire[16] = std::byte('O'), old_wire[17] = std::byte('l'), old_wire[18] = std::byte('d'), old_wire[19] = std::byte('W');
+    a::init_from_buffer(old_wire, sizeof(old_wire));
+    // a name of 4 GiB or more doesn't fit the 32-bit name size: nothing is written
+    if (sizeof(std::size_t) > 4) {
+        std::string_view huge_name(reinterpret_cast<char const *>(old_wire), std::size_t(std::uint32_t(-1)) + 1);
+        std::size_t huge_size = a::write_params(a::params_view{huge_name, 1}, nullptr, 0);
+        std::cout << "write_params of a 4 GiB name: " << huge_size << "\n";
+        if (huge_size != 0)
+            return 1;
+    }
+    try {
+        a::init_from_buffer(old_wire, 8);
+    } catch (std::invalid_argument const & e) {
+        std::cout << "init_from_buffer of a truncated buffer: " << e.what() << "\n";
+    }
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+    // the library takes arrays of params from C++11 ABI clients only
+    // init of every record of a params mapping, from memory and from a file, on the calling thread only
+    a::params records[] = {{"Mapped 0", 90}, {"Mapped 1", 91}};
+    std::vector<std::byte> mapping(a::write_params_mapping(records, 2, nullptr, 0));
+    a::write_params_mapping(records, 2, mapping.data(), mapping.size());
+    a::init_from_mapping(mapping.data(), mapping.size(), 1);
+    {
+        std::ofstream file("test_api_params.bin", std::ios::binary);
+        file.write(reinterpret_cast<char const *>(mapping.data()), static_cast<std::streamsize>(mapping.size()));
+    }
+    a::init_from_file("test_api_params.bin", 1);
+    std::remove("test_api_params.bin");
+    try {
+        a::init_from_file("test_api_params.bin");
+    } catch (std::system_error const & e) {
+        std::cout << "init_from_file of a missing file: " << e.code().message() << "\n";
+    }
+    // batch init on the calling thread only, so the output order is fixed
+    a::params batch[] = {{"Batch 0", 60}, {"Batch 1", 61}};
+    a::init_batch(batch, 2, 1);
+#endif
     a::foo();
     std::cout << "bar(): " << a::bar() << "\n";
     // case 4 - usage
     a::some_class some_class_instance(5, 6);
     a::use_some_class(some_class_instance);
+    // case 4 - batch usage
+    std::vector<a::some_class> some_class_array{{1, 2}, {3, 4}};
+    a::use_some_class(some_class_array.begin(), some_class_array.end());
 
     // case 5 - internal class
     a::exposed_internal_class exposed_class_instance(25);
     std::cout << "exposed_internal_class.get_value(): " << exposed_class_instance.get_value() << "\n";
+    exposed_class_instance.set_value(28);
+    std::cout << "exposed_internal_class.get_value() after set_value(28): " << exposed_class_instance.get_value() << "\n";
+    a::exposed_internal_class named_instance(26, "Bob");
+    std::cout << "exposed_internal_class.get_name(): " << named_instance.get_name() << "\n";
+    // names without allocations in the library
+    auto named_ptr = a::create_internal_class_instance(27, "Alice");
+    char name_buffer[16];
+    std::size_t name_size = a::get_name(named_ptr, name_buffer, sizeof(name_buffer));
+    std::cout << "get_name(named_ptr, buffer): " << std::string_view(name_buffer, name_size) << "\n";
+    std::cout << "get_name_view(named_ptr): " << a::get_name_view(named_ptr) << "\n";
+
+    // case 5 - batch creation
+    int const values[] = {1, 2, 3};
+    a::internal_class_sptr instances[3];
+    a::create_internal_class_instances(values, 3, instances);
+    for (auto const & instance : instances)
+        std::cout << "get_value(instances[i]): " << a::get_value(instance) << "\n";
+    // batch read
+    int read_values[3];
+    a::get_values(instances, 3, read_values);
+    std::cout << "get_values(instances): " << read_values[0] << " " << read_values[1] << " " << read_values[2] << "\n";
+
+    // case 5 - handle based wrapper
+    a::light_exposed_internal_class light_instance(35);
+    std::cout << "light_exposed_internal_class.get_value(): " << light_instance.get_value() << "\n";
+    a::light_exposed_internal_class named_light_instance(36, "Dave");
+    named_light_instance.set_value(37);
+    std::cout << "light_exposed_internal_class.get_name(): " << named_light_instance.get_name()
+              << ", get_value() after set_value(37): " << named_light_instance.get_value() << "\n";
+    std::cout << "get_value(light_exposed_internal_class.instance()): " << a::get_value(named_light_instance.instance()) << "\n";
+    auto stale_handle = a::create_internal_class_handle(45);
+    a::destroy_internal_class_handle(stale_handle);
+    try {
+        a::get_value(stale_handle);
+    } catch (std::invalid_argument const & e) {
+        std::cout << "get_value(stale_handle): " << e.what() << "\n";
+    }
+
+    // case 5 - registry by key
+    a::register_instance(7, a::create_internal_class_instance(55, "Carol"));
+    std::cout << "get_value(find_instance(7)): " << a::get_value(a::find_instance(7)) << "\n";
+    a::unregister_instance(7);
+    std::cout << "find_instance(7) after unregister_instance(7): " << (a::find_instance(7) ? "found" : "nullptr") << "\n";
+
+    // library allocations from the caller's memory resource
+    counting_resource resource;
+    a::set_thread_memory_resource(&resource);
+    {
+        auto arena_ptr = a::create_internal_class_instance(65, "a name that is too long for std::string to store inline");
+        a::init_async(a::params_view{"Arena", 66}).get();
+        std::cout << "get_memory_resource() == &resource: " << (a::get_memory_resource() == &resource) << "\n";
+        std::cout << "allocations from resource: " << resource.allocations << "\n";
+    }
+    a::set_thread_memory_resource(nullptr);
+
+    // calls through the function table
+    auto const & table = a::cached_api_table();
+    std::cout << "cached_api_table().get_value(named_ptr): " << table.get_value(named_ptr) << "\n";
+    std::cout << "get_api_table(current_api_version + 1): " << (a::get_api_table(a::current_api_version + 1) ? "found" : "nullptr") << "\n";
+#if !defined(API_UPDATES_PRE_CXX11_ABI)
+    a::params table_batch[] = {{"Table batch", 62}};
+    a::api_table_init_batch(table, table_batch, 1, 1);
+    std::cout << "api_table_write_params_mapping size: " << a::api_table_write_params_mapping(table, table_batch, 1, nullptr, 0) << "\n";
+#endif
+
+    // call statistics, if the library was built with them
+    a::call_stats stats[64];
+    std::size_t entry_points = a::get_call_stats(stats, 64);
+    for (std::size_t i = 0; i < entry_points && i < 64; ++i) {
+        if (stats[i].calls)
+            std::cout << "calls of " << a::get_entry_point_name(a::entry_point(i)) << ": " << stats[i].calls << "\n";
+    }
+
+    // output redirection
+    std::cout.flush();
+    a::set_output_sink(&first_record_sink, nullptr);
+    a::set_output_mode(a::output_mode::async);
+    a::foo(0);
+    a::foo(1);
+    a::flush_output();
+    a::set_output_mode(a::output_mode::discard);
+    a::foo(2);
+    a::set_output_mode(a::output_mode::sync_stdout);
+    a::foo(3);
+    // exit_record is destroyed after the output thread stopped
+    a::set_output_sink(&print_with_prefix, const_cast<char *>("[at exit] "));
+    a::set_output_mode(a::output_mode::async);
     return 0;
 }
@@ -0,0 +1,101 @@
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <api_updates/coro.hpp>
+
+namespace {
+// a single-threaded run loop: everything posted to it runs on the thread that calls run()
+class run_loop {
+public:
+    struct executor {
+        run_loop * loop;
+        void execute(std::function<void()> f) const { loop->post(std::move(f)); }
+    };
+
+    void post(std::function<void()> f)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(f));
+        _wake.notify_one();
+    }
+
+    void run()
+    {
+        _thread = std::this_thread::get_id();
+        while (!_stopped) {
+            std::function<void()> f;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this] { return !_queue.empty(); });
+                f = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            f();
+        }
+    }
+
+    void stop() { _stopped = true; }
+    executor get_executor() { return {this}; }
+    bool on_loop_thread() const { return std::this_thread::get_id() == _thread; }
+
+private:
+    std::mutex                        _mutex;
+    std::condition_variable           _wake;
+    std::deque<std::function<void()>> _queue;
+    bool                              _stopped = false;
+    std::thread::id                   _thread;
+};
+
+// set when the coroutine went on on another thread than the loop's
+bool wrong_thread = false;
+
+void check_thread(run_loop const & loop, char const * after)
+{
+    if (loop.on_loop_thread())
+        return;
+    std::cout << "resumed off the loop thread after " << after << "\n";
+    wrong_thread = true;
+}
+
+// fire-and-forget coroutine
+struct task {
+    struct promise_type {
+        task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+task run(run_loop & loop)
+{
+    co_await a::init_co(a::params_view{"Coroutine", 80}, loop.get_executor());
+    check_thread(loop, "init_co");
+    a::light_exposed_internal_class instance(90);
+    std::cout << "co_await get_value_co(handle): " << co_await a::get_value_co(instance.handle()) << "\n";
+    check_thread(loop, "get_value_co");
+    auto stale_handle = a::create_internal_class_handle(45);
+    a::destroy_internal_class_handle(stale_handle);
+    try {
+        co_await a::get_value_co(stale_handle);
+    } catch (std::invalid_argument const & e) {
+        std::cout << "co_await get_value_co(stale_handle): " << e.what() << "\n";
+    }
+    check_thread(loop, "get_value_co(stale_handle)");
+    loop.stop();
+}
+}
+
+int main()
+{
+    run_loop loop;
+    // the coroutine runs up to the first co_await here, the rest of it on the loop
+    loop.post([&loop] { run(loop); });
+    loop.run();
+    return wrong_thread ? 1 : 0;
+}